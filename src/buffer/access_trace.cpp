@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.cpp
+//
+// Identification: src/buffer/access_trace.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/access_trace.h"
+
+#include <atomic>
+#include <fstream>
+#include <utility>
+
+namespace bustub {
+
+namespace {
+
+/** The trace RecordCallback appends to. */
+std::atomic<AccessTrace *> recording_trace{nullptr};
+
+}  // namespace
+
+bool AccessTrace::Save(const std::string &file_name) const {
+  std::ofstream file(file_name, std::ios::out | std::ios::trunc);
+  for (page_id_t page_id : accesses_) {
+    file << page_id << '\n';
+  }
+  return static_cast<bool>(file);
+}
+
+bool AccessTrace::Load(const std::string &file_name, AccessTrace *trace) {
+  std::ifstream file(file_name);
+  if (!file) {
+    return false;
+  }
+  std::vector<page_id_t> accesses;
+  page_id_t page_id;
+  while (file >> page_id) {
+    accesses.push_back(page_id);
+  }
+  if (!file.eof()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(trace->latch_);
+  trace->accesses_ = std::move(accesses);
+  return true;
+}
+
+void AccessTrace::StartRecording(AccessTrace *trace) { recording_trace.store(trace); }
+
+void AccessTrace::RecordCallback(BufferPoolManager::CallbackType callback_type, page_id_t page_id) {
+  AccessTrace *trace = recording_trace.load(std::memory_order_relaxed);
+  if (trace != nullptr && callback_type == BufferPoolManager::CallbackType::BEFORE) {
+    trace->Append(page_id);
+  }
+}
+
+}  // namespace bustub
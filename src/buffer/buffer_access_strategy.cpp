@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.cpp
+//
+// Identification: src/buffer/buffer_access_strategy.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_access_strategy.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+BufferAccessStrategy::BufferAccessStrategy(BufferPoolManager *bpm, size_t ring_size)
+    : bpm_(bpm), ring_(ring_size, INVALID_PAGE_ID) {
+  BUSTUB_ASSERT(ring_size > 0, "A ring needs at least one page.");
+}
+
+void BufferAccessStrategy::OnPageLoaded(page_id_t page_id) {
+  page_id_t oldest = ring_[next_];
+  ring_[next_] = page_id;
+  next_ = (next_ + 1) % ring_.size();
+  // A page that is still pinned, e.g. because the scan is still on it or somebody else picked it up, stays put.
+  if (oldest != INVALID_PAGE_ID && oldest != page_id && bpm_->ReleasePage(oldest)) {
+    num_released_++;
+  }
+}
+
+}  // namespace bustub
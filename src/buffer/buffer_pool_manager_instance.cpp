@@ -0,0 +1,606 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.cpp
+//
+// Identification: src/buffer/buffer_pool_manager_instance.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <algorithm>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <list>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     size_t replacer_k, int numa_node, size_t max_pool_size)
+    : pool_size_(pool_size),
+      max_pool_size_(std::max(pool_size, max_pool_size)),
+      arena_(max_pool_size_, numa_node, disk_manager->GetPageSize()),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      page_table_(max_pool_size_),
+      prefetcher_([this](page_id_t page_id, const next_page_fn &next_page) { return ReadAhead(page_id, next_page); }),
+      page_cleaner_([this] { return CleanColdPages(); }) {
+  // We allocate a consecutive memory space for the frames' metadata, each pointing to its data in the arena.
+  pages_ = static_cast<Page *>(::operator new[](max_pool_size_ * sizeof(Page), std::align_val_t{alignof(Page)}));
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    new (&pages_[i]) Page(arena_.GetFrame(static_cast<frame_id_t>(i)), arena_.GetFrameSize());
+  }
+  replacer_ = Replacer::Create(replacer_type, max_pool_size_, replacer_k);
+
+  // Initially, every page is in the free list. Free and retired frames are held exclusively so that a stale lock-free
+  // lookup can never pin them.
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    pages_[i].pin_count_.store(FRAME_EXCLUSIVE, std::memory_order_relaxed);
+    if (i < pool_size) {
+      free_list_.emplace_back(static_cast<int>(i));
+    }
+  }
+}
+
+BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  // The background threads may still be working on our frames.
+  page_cleaner_.Stop();
+  prefetcher_.Stop();
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    pages_[i].~Page();
+  }
+  ::operator delete[](pages_, std::align_val_t{alignof(Page)});
+  delete replacer_;
+}
+
+Page *BufferPoolManagerInstance::FetchPageImpl(page_id_t page_id) {
+  return FetchPageWithStrategyImpl(page_id, nullptr);
+}
+
+Page *BufferPoolManagerInstance::FetchPageWithStrategyImpl(page_id_t page_id, BufferAccessStrategy *strategy) {
+  frame_id_t frame_id;
+  Page *page;
+  bool loaded = false;
+  // Fast path: the page is resident, pin it without taking the latch.
+  if (page_table_.Find(page_id, &frame_id) && TryPinResident(frame_id, page_id)) {
+    page = &pages_[frame_id];
+  } else {
+    auto slow_path_start = std::chrono::steady_clock::now();
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      // 1.     Search the page table for the requested page (P).
+      // 1.1    If P exists, pin it and return it immediately.
+      // Under the latch the frame cannot be held exclusively, so pinning only fails if P was evicted in the meantime.
+      if (page_table_.Find(page_id, &frame_id) && TryPinResident(frame_id, page_id)) {
+        page = &pages_[frame_id];
+      } else {
+        // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+        // 2.     If R is dirty, write it back to the disk.
+        // 3.     Delete R from the page table and insert P.
+        if (!AcquireFrame(&frame_id)) {
+          return nullptr;
+        }
+        // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+        page = &pages_[frame_id];
+        page->page_id_.store(page_id, std::memory_order_release);
+        page->is_dirty_.store(false, std::memory_order_relaxed);
+        page->prefetched_.store(false, std::memory_order_relaxed);
+        ReadFrame(page_id, page);
+        page->pin_count_.store(1, std::memory_order_release);
+        page_table_.Insert(page_id, frame_id);
+        replacer_->Pin(frame_id);
+        loaded = true;
+      }
+    }
+    auto slow_path_time = std::chrono::steady_clock::now() - slow_path_start;
+    stats_.Add(BufferPoolStats::Counter::SLOW_PATH_NS,
+               std::chrono::duration_cast<std::chrono::nanoseconds>(slow_path_time).count());
+  }
+  stats_.Add(loaded ? BufferPoolStats::Counter::MISS : BufferPoolStats::Counter::HIT);
+  stats_.RecordAccess(page_id);
+  // A read-ahead page counts as loaded by whoever fetches it first: for a scan, that is what brought it in.
+  if (page->prefetched_.load(std::memory_order_relaxed) && page->prefetched_.exchange(false)) {
+    loaded = true;
+  }
+  // The strategy may release a page of this very instance, so it must run without the latch.
+  if (loaded && strategy != nullptr) {
+    strategy->OnPageLoaded(page_id);
+  }
+  return page;
+}
+
+bool BufferPoolManagerInstance::ReleasePageImpl(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return false;
+  }
+  Page *page = &pages_[frame_id];
+  int expected = 0;
+  if (!page->pin_count_.compare_exchange_strong(expected, FRAME_EXCLUSIVE)) {
+    return false;
+  }
+  stats_.Add(BufferPoolStats::Counter::EVICTION);
+  if (page->is_dirty_.load(std::memory_order_relaxed)) {
+    WriteBackFrame(frame_id);
+  }
+  page_table_.Remove(page_id);
+  replacer_->Remove(frame_id);
+  page->page_id_.store(INVALID_PAGE_ID, std::memory_order_release);
+  // The frame stays held exclusively while it is free.
+  free_list_.push_front(frame_id);
+  return true;
+}
+
+void BufferPoolManagerInstance::PrefetchPageImpl(page_id_t page_id, size_t depth, const next_page_fn &next_page) {
+  prefetcher_.Enqueue(page_id, depth, next_page);
+}
+
+page_id_t BufferPoolManagerInstance::ReadAhead(page_id_t page_id, const next_page_fn &next_page) {
+  IOTagScope io_tag(IOTag::PREFETCH);
+  frame_id_t frame_id;
+  Page *page = nullptr;
+  // A resident page only needs to be pinned if we have to look inside it for the next page.
+  if (page_table_.Find(page_id, &frame_id)) {
+    if (next_page == nullptr) {
+      return INVALID_PAGE_ID;
+    }
+    if (TryPinResident(frame_id, page_id, false)) {
+      page = &pages_[frame_id];
+    }
+  }
+  if (page == nullptr) {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (page_table_.Find(page_id, &frame_id)) {
+      // Somebody else loaded it in the meantime.
+      if (next_page == nullptr || !TryPinResident(frame_id, page_id, false)) {
+        return INVALID_PAGE_ID;
+      }
+      page = &pages_[frame_id];
+    } else {
+      // Read-ahead never waits for a frame: if every frame is pinned, the scan will read the page itself.
+      if (!AcquireFrame(&frame_id)) {
+        return INVALID_PAGE_ID;
+      }
+      page = &pages_[frame_id];
+      page->page_id_.store(page_id, std::memory_order_release);
+      page->is_dirty_.store(false, std::memory_order_relaxed);
+      page->prefetched_.store(true, std::memory_order_relaxed);
+      stats_.Add(BufferPoolStats::Counter::PREFETCH);
+      ReadFrame(page_id, page);
+      // Pinned without telling the replacer, so that the read does not count as an access.
+      page->pin_count_.store(1, std::memory_order_release);
+      page_table_.Insert(page_id, frame_id);
+    }
+  }
+  page_id_t next_page_id = next_page == nullptr ? INVALID_PAGE_ID : next_page(page);
+  DecrementPin(frame_id);
+  return next_page_id;
+}
+
+size_t BufferPoolManagerInstance::CleanColdPages(size_t max_pages) {
+  IOTagScope io_tag(IOTag::PAGE_CLEANER);
+  // The whole batch is in flight at once; wait for it so that the pass is over when we return.
+  std::mutex done_latch;
+  std::condition_variable done_cv;
+  size_t in_flight = 0;
+  size_t cleaned = 0;
+  for (frame_id_t frame_id : replacer_->ColdFrames(max_pages)) {
+    {
+      std::lock_guard<std::mutex> guard(done_latch);
+      in_flight++;
+    }
+    bool started = CleanFrame(frame_id, [&] {
+      std::lock_guard<std::mutex> guard(done_latch);
+      in_flight--;
+      // Notified under the latch, since the waiter's stack frame goes away as soon as it sees the last completion.
+      done_cv.notify_one();
+    });
+    std::lock_guard<std::mutex> guard(done_latch);
+    if (started) {
+      cleaned++;
+    } else {
+      in_flight--;
+    }
+  }
+  std::unique_lock<std::mutex> lock(done_latch);
+  done_cv.wait(lock, [&] { return in_flight == 0; });
+  return cleaned;
+}
+
+bool BufferPoolManagerInstance::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  // No latch: the caller's pin keeps the page in its frame, so the lock-free lookup is stable, and only the last
+  // unpin touches the replacer.
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return false;
+  }
+  Page *page = &pages_[frame_id];
+  if (page->GetPinCount() <= 0 || page->page_id_.load(std::memory_order_acquire) != page_id) {
+    return false;
+  }
+  // Set before the pin is dropped, so that whoever claims the frame once it is unpinned sees the page as dirty.
+  if (is_dirty) {
+    page->is_dirty_.store(true, std::memory_order_relaxed);
+  }
+  return DecrementPin(frame_id);
+}
+
+bool BufferPoolManagerInstance::FlushPageImpl(page_id_t page_id) {
+  frame_id_t frame_id;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    // Our pin keeps the page in its frame once we let go of the latch, without counting as an access.
+    if (page_id == INVALID_PAGE_ID || !page_table_.Find(page_id, &frame_id) ||
+        !TryPinResident(frame_id, page_id, false)) {
+      return false;
+    }
+  }
+  // The read latch keeps writers out while the page is written, so what we write is a consistent image of the page.
+  // It is taken without latch_, which the writer we wait for may need before it lets go of the page.
+  Page *page = &pages_[frame_id];
+  page->RLatch();
+  WriteBackFrame(frame_id);
+  page->RUnlatch();
+  DecrementPin(frame_id);
+  return true;
+}
+
+bool BufferPoolManagerInstance::HasFreeFrame() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return !free_list_.empty() || replacer_->Size() > 0;
+}
+
+Page *BufferPoolManagerInstance::NewPageImpl(page_id_t *page_id) {
+  // 1.   If all the pages in the buffer pool are pinned, return nullptr.
+  if (!HasFreeFrame()) {
+    *page_id = INVALID_PAGE_ID;
+    return nullptr;
+  }
+  // 0.   Make sure you call DiskManager::AllocatePage!
+  *page_id = disk_manager_->AllocatePage();
+  Page *page = NewPageWithId(*page_id);
+  if (page == nullptr) {
+    // Every frame got pinned while we were allocating; hand the id back.
+    disk_manager_->DeallocatePage(*page_id);
+    *page_id = INVALID_PAGE_ID;
+  }
+  return page;
+}
+
+Page *BufferPoolManagerInstance::NewPageInExtentImpl(page_id_t *page_id, PageExtent *extent) {
+  if (!HasFreeFrame()) {
+    *page_id = INVALID_PAGE_ID;
+    return nullptr;
+  }
+  *page_id = extent->AllocatePage(disk_manager_);
+  Page *page = NewPageWithId(*page_id);
+  if (page == nullptr) {
+    // The extent cannot take the page back, so it goes to the free space map like any deleted page.
+    disk_manager_->DeallocatePage(*page_id);
+    *page_id = INVALID_PAGE_ID;
+  }
+  return page;
+}
+
+Page *BufferPoolManagerInstance::NewPageWithId(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+  frame_id_t frame_id;
+  if (!AcquireFrame(&frame_id)) {
+    return nullptr;
+  }
+  // 3.   Update P's metadata, zero out memory and add P to the page table.
+  Page *page = &pages_[frame_id];
+  page->page_id_.store(page_id, std::memory_order_release);
+  page->is_dirty_.store(false, std::memory_order_relaxed);
+  page->prefetched_.store(false, std::memory_order_relaxed);
+  page->ResetMemory();
+  page->pin_count_.store(1, std::memory_order_release);
+  page_table_.Insert(page_id, frame_id);
+  replacer_->Pin(frame_id);
+  // 4.   Set the page ID output parameter. Return a pointer to P.
+  return page;
+}
+
+bool BufferPoolManagerInstance::DeletePageImpl(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // 1.   Search the page table for the requested page (P).
+  frame_id_t frame_id;
+  // 1.   If P does not exist, return true.
+  if (compressed_tier_ != nullptr) {
+    compressed_tier_->Invalidate(page_id);
+  }
+  if (!page_table_.Find(page_id, &frame_id)) {
+    disk_manager_->DeallocatePage(page_id);
+    return true;
+  }
+  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+  Page *page = &pages_[frame_id];
+  int expected = 0;
+  if (!page->pin_count_.compare_exchange_strong(expected, FRAME_EXCLUSIVE)) {
+    return false;
+  }
+  // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+  page_table_.Remove(page_id);
+  replacer_->Remove(frame_id);
+  page->page_id_.store(INVALID_PAGE_ID, std::memory_order_release);
+  page->is_dirty_.store(false, std::memory_order_relaxed);
+  page->ResetMemory();
+  free_list_.push_back(frame_id);
+  // 0.   Make sure you call DiskManager::DeallocatePage!
+  disk_manager_->DeallocatePage(page_id);
+  return true;
+}
+
+bool BufferPoolManagerInstance::Resize(size_t pool_size) {
+  std::lock_guard<std::mutex> guard(latch_);
+  size_t old_pool_size = pool_size_.load(std::memory_order_relaxed);
+  if (pool_size == 0 || pool_size > max_pool_size_) {
+    return false;
+  }
+  if (pool_size >= old_pool_size) {
+    // Retired frames were zeroed when they were discarded, so they can go straight to the free list.
+    for (size_t i = old_pool_size; i < pool_size; i++) {
+      free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+    pool_size_.store(pool_size, std::memory_order_release);
+    return true;
+  }
+
+  // Under the latch a frame is held exclusively only if it is free, so every other frame that goes away must be
+  // claimed from pin count 0 before anything is evicted; otherwise the pool is left as it was.
+  std::vector<frame_id_t> claimed;
+  for (size_t i = pool_size; i < old_pool_size; i++) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    int expected = 0;
+    if (pages_[i].pin_count_.compare_exchange_strong(expected, FRAME_EXCLUSIVE)) {
+      claimed.push_back(frame_id);
+    } else if (expected != FRAME_EXCLUSIVE) {
+      for (frame_id_t claimed_id : claimed) {
+        pages_[claimed_id].pin_count_.store(0, std::memory_order_release);
+      }
+      return false;
+    }
+  }
+  for (frame_id_t frame_id : claimed) {
+    Page *page = &pages_[frame_id];
+    stats_.Add(BufferPoolStats::Counter::EVICTION);
+    if (page->is_dirty_.load(std::memory_order_relaxed)) {
+      WriteBackFrame(frame_id);
+    }
+    page_table_.Remove(page->GetPageId());
+    replacer_->Remove(frame_id);
+    page->page_id_.store(INVALID_PAGE_ID, std::memory_order_release);
+    page->prefetched_.store(false, std::memory_order_relaxed);
+  }
+  free_list_.remove_if([pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; });
+  pool_size_.store(pool_size, std::memory_order_release);
+  arena_.Discard(static_cast<frame_id_t>(pool_size), old_pool_size - pool_size);
+  return true;
+}
+
+void BufferPoolManagerInstance::FlushAllPagesImpl() {
+  std::vector<Page *> batch;
+  CollectFlushBatch(&batch);
+  if (size_t failed = WriteFlushBatch(disk_manager_, &batch); failed > 0) {
+    LOG_WARN("%zu of %zu pages could not be flushed, they stay dirty", failed, batch.size());
+  }
+  ReleaseFlushBatch(batch);
+}
+
+void BufferPoolManagerInstance::CollectFlushBatch(std::vector<Page *> *batch) {
+  std::lock_guard<std::mutex> guard(latch_);
+  size_t pool_size = pool_size_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < pool_size; i++) {
+    Page *page = &pages_[i];
+    page_id_t page_id = page->GetPageId();
+    if (page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    // A pinned page may have been changed by somebody who has not unpinned it as dirty yet.
+    bool pinned = page->pin_count_.load(std::memory_order_acquire) > 0;
+    if (!page->is_dirty_.load(std::memory_order_relaxed) && !pinned) {
+      continue;
+    }
+    if (!TryPinResident(static_cast<frame_id_t>(i), page_id, false)) {
+      continue;
+    }
+    batch->push_back(page);
+    stats_.Add(BufferPoolStats::Counter::PAGE_WRITE);
+  }
+}
+
+size_t BufferPoolManagerInstance::WriteFlushBatch(DiskManager *disk_manager, std::vector<Page *> *batch) {
+  if (batch->empty()) {
+    return 0;
+  }
+  // In page id order, so that consecutive pages end up in the same chunk and are written together.
+  std::sort(batch->begin(), batch->end(), [](Page *a, Page *b) { return a->GetPageId() < b->GetPageId(); });
+  size_t page_size = disk_manager->GetPageSize();
+  size_t staging_size = std::min(FLUSH_CHUNK_PAGES, batch->size()) * page_size;
+  // Aligned for O_DIRECT, so that the disk manager can write the copies as they are.
+  auto *staging = static_cast<char *>(::operator new(staging_size, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+  std::vector<std::pair<page_id_t, const char *>> chunk;
+  size_t failed = 0;
+  for (size_t start = 0; start < batch->size(); start += FLUSH_CHUNK_PAGES) {
+    chunk.clear();
+    for (size_t i = start; i < std::min(start + FLUSH_CHUNK_PAGES, batch->size()); i++) {
+      Page *page = (*batch)[i];
+      char *copy = staging + (i - start) * page_size;
+      // The read latch keeps writers out while the page is copied, so the copy is a consistent image of the page. Only
+      // one latch is held at a time, so the flush cannot deadlock with a thread that latches several pages.
+      page->RLatch();
+      // Cleared before copying, so that a change made after our copy is not lost when its writer unpins the page.
+      page->is_dirty_.store(false, std::memory_order_relaxed);
+      memcpy(copy, page->GetData(), page_size);
+      page->RUnlatch();
+      chunk.emplace_back(page->GetPageId(), copy);
+    }
+    // The pages that did not make it to disk still differ from it, so they must be written again by a later flush or
+    // their eviction. Both the failed ids and this part of the batch are in page id order.
+    auto chunk_end = batch->begin() + std::min(start + FLUSH_CHUNK_PAGES, batch->size());
+    auto page = batch->begin() + start;
+    for (page_id_t failed_page_id : disk_manager->WritePages(&chunk)) {
+      page = std::lower_bound(page, chunk_end, failed_page_id,
+                              [](Page *a, page_id_t page_id) { return a->GetPageId() < page_id; });
+      (*page)->is_dirty_.store(true, std::memory_order_relaxed);
+      failed++;
+    }
+  }
+  ::operator delete(staging, std::align_val_t{DIRECT_IO_ALIGNMENT});
+  return failed;
+}
+
+void BufferPoolManagerInstance::ReleaseFlushBatch(const std::vector<Page *> &batch) {
+  for (Page *page : batch) {
+    // Pages of other instances of a ParallelBufferPoolManager lie outside our frames.
+    if (page >= pages_ && page < pages_ + max_pool_size_) {
+      DecrementPin(static_cast<frame_id_t>(page - pages_));
+    }
+  }
+}
+
+bool BufferPoolManagerInstance::CleanFrame(frame_id_t frame_id, const std::function<void()> &on_written) {
+  Page *page = &pages_[frame_id];
+  page_id_t page_id;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    page_id = page->GetPageId();
+    // Pages somebody has pinned are probably about to be dirtied again; leave them alone.
+    if (page_id == INVALID_PAGE_ID || !page->is_dirty_.load(std::memory_order_relaxed) ||
+        page->pin_count_.load(std::memory_order_acquire) != 0) {
+      return false;
+    }
+    // Our pin keeps the page from being evicted while it is written, without counting as an access.
+    if (!TryPinResident(frame_id, page_id, false)) {
+      return false;
+    }
+  }
+
+  // The read latch keeps writers out until the write completes, so what we write is a consistent image of the page.
+  page->RLatch();
+  // Write-ahead logging: the log records of the page's last change must be on disk before the page is.
+  if (enable_logging && log_manager_ != nullptr && page->GetLSN() > log_manager_->GetPersistentLSN()) {
+    page->RUnlatch();
+    DecrementPin(frame_id);
+    return false;
+  }
+  // Cleared before writing, so that a change made after our write is not lost when its writer unpins the page.
+  page->is_dirty_.store(false, std::memory_order_relaxed);
+  disk_manager_->WritePageAsync(page_id, page->GetData(), [this, frame_id, page, on_written](bool success) {
+    if (success) {
+      stats_.Add(BufferPoolStats::Counter::PAGE_WRITE);
+      stats_.Add(BufferPoolStats::Counter::CLEANER_WRITE);
+    } else {
+      // The page is still different from disk; a later pass or its eviction writes it again.
+      page->is_dirty_.store(true, std::memory_order_relaxed);
+    }
+    page->RUnlatch();
+    DecrementPin(frame_id);
+    on_written();
+  });
+  return true;
+}
+
+bool BufferPoolManagerInstance::TryPinResident(frame_id_t frame_id, page_id_t page_id, bool record_access) {
+  Page *page = &pages_[frame_id];
+  int pins = page->pin_count_.load(std::memory_order_acquire);
+  do {
+    if (pins < 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pins, pins + 1, std::memory_order_acq_rel));
+  // The page id only changes while the frame is held exclusively, so once pinned it is stable. It may still differ
+  // from the one we looked up if the frame was recycled between the lookup and the pin.
+  if (page->page_id_.load(std::memory_order_acquire) != page_id) {
+    DecrementPin(frame_id);
+    return false;
+  }
+  if (pins == 0 && record_access) {
+    replacer_->Pin(frame_id);
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::DecrementPin(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  int pins = page->pin_count_.load(std::memory_order_acquire);
+  do {
+    if (pins <= 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pins, pins - 1, std::memory_order_acq_rel));
+  if (pins == 1) {
+    // The replacer is only a hint: a frame handed to it may be pinned again concurrently, which is why evictions
+    // re-check the pin count before claiming a victim.
+    replacer_->Unpin(frame_id);
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  while (replacer_->Victim(frame_id)) {
+    Page *victim = &pages_[*frame_id];
+    int expected = 0;
+    // A lock-free fetch may have pinned the victim after the replacer chose it; skip it, it will come back to the
+    // replacer when it is unpinned again.
+    if (!victim->pin_count_.compare_exchange_strong(expected, FRAME_EXCLUSIVE)) {
+      continue;
+    }
+    // Only now is the eviction certain, so only now may the replacer forget the page's history.
+    replacer_->Remove(*frame_id);
+    stats_.Add(BufferPoolStats::Counter::EVICTION);
+    if (victim->is_dirty_.load(std::memory_order_relaxed)) {
+      stats_.Add(BufferPoolStats::Counter::DIRTY_EVICTION);
+      // The page cleaner did not keep up; the next pass should not wait for its timer.
+      page_cleaner_.Wake();
+      IOTagScope io_tag(IOTag::EVICTION);
+      WriteBackFrame(*frame_id);
+    }
+    if (compressed_tier_ != nullptr) {
+      compressed_tier_->Put(victim->GetPageId(), victim->GetData());
+    }
+    page_table_.Remove(victim->GetPageId());
+    return true;
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::SetCompressedTierCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> guard(latch_);
+  compressed_tier_ = capacity == 0 ? nullptr : std::make_unique<CompressedPageCache>(capacity, arena_.GetFrameSize());
+}
+
+void BufferPoolManagerInstance::ReadFrame(page_id_t page_id, Page *page) {
+  if (compressed_tier_ != nullptr && compressed_tier_->Take(page_id, page->GetData())) {
+    stats_.Add(BufferPoolStats::Counter::COMPRESSED_HIT);
+    return;
+  }
+  disk_manager_->ReadPage(page_id, page->GetData());
+}
+
+void BufferPoolManagerInstance::WriteBackFrame(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  // Cleared before writing: unpins do not take the latch, so one may mark the page dirty again while it is written.
+  page->is_dirty_.store(false, std::memory_order_relaxed);
+  disk_manager_->WritePage(page->GetPageId(), page->GetData());
+  stats_.Add(BufferPoolStats::Counter::PAGE_WRITE);
+}
+
+}  // namespace bustub
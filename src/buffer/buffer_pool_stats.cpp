@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+double BufferPoolCounters::HitRate() const {
+  uint64_t fetches = hits_ + misses_;
+  return fetches == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(fetches);
+}
+
+BufferPoolCounters &BufferPoolCounters::operator+=(const BufferPoolCounters &other) {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  evictions_ += other.evictions_;
+  dirty_evictions_ += other.dirty_evictions_;
+  page_writes_ += other.page_writes_;
+  cleaner_writes_ += other.cleaner_writes_;
+  prefetches_ += other.prefetches_;
+  compressed_hits_ += other.compressed_hits_;
+  slow_path_ns_ += other.slow_path_ns_;
+  return *this;
+}
+
+std::string BufferPoolCounters::ToString() const {
+  std::stringstream os;
+  os << "hits: " << hits_ << "\n";
+  os << "misses: " << misses_ << "\n";
+  os << "hit_rate: " << HitRate() << "\n";
+  os << "evictions: " << evictions_ << "\n";
+  os << "dirty_evictions: " << dirty_evictions_ << "\n";
+  os << "page_writes: " << page_writes_ << "\n";
+  os << "cleaner_writes: " << cleaner_writes_ << "\n";
+  os << "prefetches: " << prefetches_ << "\n";
+  os << "compressed_hits: " << compressed_hits_ << "\n";
+  os << "slow_path_ns: " << slow_path_ns_ << "\n";
+  return os.str();
+}
+
+BufferPoolCounters BufferPoolStats::GetCounters() const {
+  uint64_t sums[static_cast<size_t>(Counter::NUM_COUNTERS)] = {};
+  for (const auto &stripe : stripes_) {
+    for (size_t i = 0; i < static_cast<size_t>(Counter::NUM_COUNTERS); i++) {
+      sums[i] += stripe.counters_[i].load(std::memory_order_relaxed);
+    }
+  }
+  BufferPoolCounters counters;
+  counters.hits_ = sums[static_cast<size_t>(Counter::HIT)];
+  counters.misses_ = sums[static_cast<size_t>(Counter::MISS)];
+  counters.evictions_ = sums[static_cast<size_t>(Counter::EVICTION)];
+  counters.dirty_evictions_ = sums[static_cast<size_t>(Counter::DIRTY_EVICTION)];
+  counters.page_writes_ = sums[static_cast<size_t>(Counter::PAGE_WRITE)];
+  counters.cleaner_writes_ = sums[static_cast<size_t>(Counter::CLEANER_WRITE)];
+  counters.prefetches_ = sums[static_cast<size_t>(Counter::PREFETCH)];
+  counters.compressed_hits_ = sums[static_cast<size_t>(Counter::COMPRESSED_HIT)];
+  counters.slow_path_ns_ = sums[static_cast<size_t>(Counter::SLOW_PATH_NS)];
+  return counters;
+}
+
+void BufferPoolStats::Reset() {
+  for (auto &stripe : stripes_) {
+    for (auto &counter : stripe.counters_) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
+  std::lock_guard<std::mutex> guard(heat_latch_);
+  heat_.clear();
+}
+
+std::vector<std::pair<page_id_t, uint64_t>> BufferPoolStats::GetHottestPages(size_t max_pages) {
+  std::lock_guard<std::mutex> guard(heat_latch_);
+  return HottestPages(heat_, max_pages);
+}
+
+void BufferPoolStats::MergeHeat(std::unordered_map<page_id_t, uint64_t> *heat) {
+  std::lock_guard<std::mutex> guard(heat_latch_);
+  for (const auto &entry : heat_) {
+    (*heat)[entry.first] += entry.second;
+  }
+}
+
+std::vector<std::pair<page_id_t, uint64_t>> BufferPoolStats::HottestPages(
+    const std::unordered_map<page_id_t, uint64_t> &heat, size_t max_pages) {
+  std::vector<std::pair<page_id_t, uint64_t>> pages(heat.begin(), heat.end());
+  auto hotter = [](const auto &a, const auto &b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  };
+  size_t num_pages = std::min(max_pages, pages.size());
+  std::partial_sort(pages.begin(), pages.begin() + num_pages, pages.end(), hotter);
+  pages.resize(num_pages);
+  return pages;
+}
+
+size_t BufferPoolStats::GetStripe() {
+  static thread_local size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id()) % NUM_STRIPES;
+  return stripe;
+}
+
+void BufferPoolStats::SampleAccess(page_id_t page_id, uint32_t sample_rate) {
+  static thread_local uint32_t countdown = 0;
+  // The countdown may be left over from a larger rate, or from another pool.
+  if (countdown > 0 && countdown < sample_rate) {
+    countdown--;
+    return;
+  }
+  countdown = sample_rate - 1;
+  std::lock_guard<std::mutex> guard(heat_latch_);
+  heat_[page_id]++;
+}
+
+}  // namespace bustub
@@ -14,16 +14,73 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : frames_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  // At most two sweeps are needed: the first one clears every reference bit.
+  while (true) {
+    ClockFrame &frame = frames_[hand_];
+    size_t current = hand_;
+    hand_ = (hand_ + 1) % frames_.size();
+    if (!frame.in_replacer_) {
+      continue;
+    }
+    if (frame.ref_) {
+      frame.ref_ = false;
+      continue;
+    }
+    frame.in_replacer_ = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(current);
+    return true;
+  }
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  ClockFrame &frame = frames_[frame_id];
+  if (frame.in_replacer_) {
+    frame.in_replacer_ = false;
+    size_--;
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  ClockFrame &frame = frames_[frame_id];
+  if (!frame.in_replacer_) {
+    frame.in_replacer_ = true;
+    frame.ref_ = true;
+    size_++;
+  }
+}
 
-size_t ClockReplacer::Size() { return 0; }
+std::vector<frame_id_t> ClockReplacer::ColdFrames(size_t max_frames) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // The hand takes the frames without a reference bit on its first sweep, and the others on its second.
+  std::vector<frame_id_t> cold;
+  std::vector<frame_id_t> referenced;
+  for (size_t i = 0; i < frames_.size() && cold.size() < max_frames; i++) {
+    size_t current = (hand_ + i) % frames_.size();
+    if (frames_[current].in_replacer_) {
+      (frames_[current].ref_ ? referenced : cold).push_back(static_cast<frame_id_t>(current));
+    }
+  }
+  for (size_t i = 0; i < referenced.size() && cold.size() < max_frames; i++) {
+    cold.push_back(referenced[i]);
+  }
+  return cold;
+}
+
+size_t ClockReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return size_;
+}
 
 }  // namespace bustub
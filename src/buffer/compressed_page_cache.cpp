@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "buffer/page_compressor.h"
+
+namespace bustub {
+
+bool CompressedPageCache::Put(page_id_t page_id, const char *data) {
+  Invalidate(page_id);
+  size_t size = PageCompressor::Compress(data, page_size_, buffer_.get(), max_compressed_size_);
+  if (size == 0 || size > capacity_) {
+    return false;
+  }
+  MakeRoom(size);
+  Entry entry{page_id, size, std::make_unique<char[]>(size)};
+  memcpy(entry.data_.get(), buffer_.get(), size);
+  entries_.push_back(std::move(entry));
+  index_[page_id] = std::prev(entries_.end());
+  used_bytes_ += size;
+  return true;
+}
+
+bool CompressedPageCache::Take(page_id_t page_id, char *data) {
+  auto it = index_.find(page_id);
+  if (it == index_.end()) {
+    return false;
+  }
+  bool decompressed = PageCompressor::Decompress(it->second->data_.get(), it->second->size_, data, page_size_);
+  Invalidate(page_id);
+  return decompressed;
+}
+
+void CompressedPageCache::Invalidate(page_id_t page_id) {
+  auto it = index_.find(page_id);
+  if (it == index_.end()) {
+    return;
+  }
+  used_bytes_ -= it->second->size_;
+  entries_.erase(it->second);
+  index_.erase(it);
+}
+
+void CompressedPageCache::MakeRoom(size_t size) {
+  while (!entries_.empty() && used_bytes_ + size > capacity_) {
+    used_bytes_ -= entries_.front().size_;
+    index_.erase(entries_.front().page_id_);
+    entries_.pop_front();
+  }
+}
+
+}  // namespace bustub
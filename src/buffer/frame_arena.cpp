@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+FrameArena::FrameArena(size_t num_frames, int numa_node, size_t frame_size) : frame_size_(frame_size) {
+  size_t size = num_frames * frame_size_;
+  void *data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  // Reserved huge pages are all or nothing, and only worth it for pools of at least one huge page.
+  if (size >= HUGE_PAGE_SIZE) {
+    size_ = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    huge_pages_ = data != MAP_FAILED;
+  }
+#endif
+  if (data == MAP_FAILED) {
+    size_ = size == 0 ? frame_size_ : size;
+    // Frames of a pool that may grow later are not committed until they are used.
+    data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    // Let the kernel back the arena with transparent huge pages where it can.
+    madvise(data, size_, MADV_HUGEPAGE);
+#endif
+  }
+  data_ = static_cast<char *>(data);
+
+#if defined(__linux__) && defined(SYS_mbind)
+  // The mapping has not been touched yet, so binding it now places every frame on the node when it is first used.
+  if (numa_node != NO_NUMA_NODE && numa_node < static_cast<int>(sizeof(unsigned long) * 8)) {  // NOLINT
+    const int mpol_preferred = 1;
+    unsigned long node_mask = 1UL << numa_node;  // NOLINT
+    if (syscall(SYS_mbind, data_, size_, mpol_preferred, &node_mask, sizeof(node_mask) * 8, 0) != 0) {
+      LOG_DEBUG("could not bind the frame arena to NUMA node %d", numa_node);
+    }
+  }
+#endif
+}
+
+FrameArena::~FrameArena() { munmap(data_, size_); }
+
+void FrameArena::Discard(frame_id_t first_frame, size_t num_frames) {
+  char *data = GetFrame(first_frame);
+  size_t size = num_frames * frame_size_;
+  // Dropping private anonymous pages makes them read back as zeros. Reserved huge pages can only be dropped whole,
+  // so those are just zeroed.
+  if (huge_pages_ || madvise(data, size, MADV_DONTNEED) != 0) {
+    memset(data, 0, size);
+  }
+}
+
+int FrameArena::GetNumNumaNodes() {
+  int num_nodes = 0;
+  struct stat node_stat;
+  while (stat(("/sys/devices/system/node/node" + std::to_string(num_nodes)).c_str(), &node_stat) == 0) {
+    num_nodes++;
+  }
+  return num_nodes == 0 ? 1 : num_nodes;
+}
+
+}  // namespace bustub
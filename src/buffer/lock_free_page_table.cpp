@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lock_free_page_table.cpp
+//
+// Identification: src/buffer/lock_free_page_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lock_free_page_table.h"
+
+namespace bustub {
+
+LockFreePageTable::LockFreePageTable(size_t num_frames) : capacity_(2), shift_(63) {
+  while (capacity_ < 2 * num_frames) {
+    capacity_ <<= 1;
+    shift_--;
+  }
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (uint64_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY, std::memory_order_relaxed);
+  }
+}
+
+void LockFreePageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  const uint64_t mask = capacity_ - 1;
+  uint64_t target = EMPTY;
+  for (uint64_t i = Hash(page_id), probes = 0; probes < capacity_; i = (i + 1) & mask, probes++) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == TOMBSTONE) {
+      // Reuse the first tombstone on the probe sequence, which keeps chains short.
+      target = i;
+      break;
+    }
+    if (slot == EMPTY) {
+      target = i;
+      break;
+    }
+    BUSTUB_ASSERT(KeyOf(slot) != page_id, "Page is already in the page table.");
+  }
+  BUSTUB_ASSERT(target != EMPTY, "Page table is full.");
+  // Publishing the slot makes the entry visible to lock-free readers.
+  slots_[target].store(Pack(page_id, frame_id), std::memory_order_release);
+  size_++;
+}
+
+bool LockFreePageTable::Remove(page_id_t page_id) {
+  const uint64_t mask = capacity_ - 1;
+  for (uint64_t i = Hash(page_id), probes = 0; probes < capacity_; i = (i + 1) & mask, probes++) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY) {
+      return false;
+    }
+    if (slot == TOMBSTONE || KeyOf(slot) != page_id) {
+      continue;
+    }
+    slots_[i].store(TOMBSTONE, std::memory_order_release);
+    size_--;
+    // No probe sequence can cross an empty slot, so a tombstone that is followed by an empty slot is not on the path
+    // of any live key and can become empty itself. Walk backwards to reclaim the whole run.
+    uint64_t j = i;
+    while (slots_[(j + 1) & mask].load(std::memory_order_relaxed) == EMPTY &&
+           slots_[j].load(std::memory_order_relaxed) == TOMBSTONE) {
+      slots_[j].store(EMPTY, std::memory_order_release);
+      j = (j - 1) & mask;
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t correlated_period)
+    : k_(k), correlated_period_(correlated_period), frames_(num_pages) {
+  BUSTUB_ASSERT(k > 0, "LRU-K needs to remember at least one access.");
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // Infinite backward k-distance wins over any finite one.
+  auto &from = cold_.empty() ? hot_ : cold_;
+  if (from.empty()) {
+    return false;
+  }
+  *frame_id = from.begin()->second;
+  from.erase(from.begin());
+  // The history stays until the caller confirms the eviction with Remove: if the page is pinned again before the
+  // caller can claim the frame, it must not come back with an infinite backward k-distance.
+  frames_[*frame_id].evictable_ = false;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  MakeUnevictable(frame_id);
+  FrameHistory &frame = frames_[frame_id];
+  size_t now = current_timestamp_++;
+  bool correlated = !frame.accesses_.empty() && now - frame.last_access_ < correlated_period_;
+  frame.last_access_ = now;
+  if (correlated) {
+    return;
+  }
+  frame.accesses_.push_back(now);
+  if (frame.accesses_.size() > k_) {
+    frame.accesses_.pop_front();
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  FrameHistory &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    return;
+  }
+  frame.evictable_ = true;
+  if (frame.accesses_.size() < k_) {
+    // A frame that was never accessed (e.g. it was only read ahead) is filed as if it had been touched just now.
+    frame.key_ = frame.accesses_.empty() ? current_timestamp_ : frame.accesses_.front();
+    cold_.emplace(frame.key_, frame_id);
+  } else {
+    frame.key_ = frame.accesses_.front();
+    hot_.emplace(frame.key_, frame_id);
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  MakeUnevictable(frame_id);
+  frames_[frame_id] = FrameHistory{};
+}
+
+std::vector<frame_id_t> LRUKReplacer::ColdFrames(size_t max_frames) {
+  std::lock_guard<std::mutex> guard(latch_);
+  std::vector<frame_id_t> frames;
+  for (const auto *from : {&cold_, &hot_}) {
+    for (auto it = from->begin(); it != from->end() && frames.size() < max_frames; ++it) {
+      frames.push_back(it->second);
+    }
+  }
+  return frames;
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return cold_.size() + hot_.size();
+}
+
+void LRUKReplacer::MakeUnevictable(frame_id_t frame_id) {
+  FrameHistory &frame = frames_[frame_id];
+  if (!frame.evictable_) {
+    return;
+  }
+  frame.evictable_ = false;
+  if (frame.accesses_.size() < k_) {
+    cold_.erase({frame.key_, frame_id});
+  } else {
+    hot_.erase({frame.key_, frame_id});
+  }
+}
+
+}  // namespace bustub
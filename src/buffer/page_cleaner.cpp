@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_cleaner.cpp
+//
+// Identification: src/buffer/page_cleaner.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_cleaner.h"
+
+#include <utility>
+
+namespace bustub {
+
+PageCleaner::PageCleaner(clean_fn clean) : clean_(std::move(clean)) {}
+
+PageCleaner::~PageCleaner() { Stop(); }
+
+void PageCleaner::Run() {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  thread_ = std::thread(&PageCleaner::Loop, this);
+}
+
+void PageCleaner::Stop() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    running_ = false;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PageCleaner::Wake() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (!running_ || woken_) {
+      return;
+    }
+    woken_ = true;
+  }
+  cv_.notify_one();
+}
+
+bool PageCleaner::IsRunning() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return running_;
+}
+
+void PageCleaner::Loop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (running_) {
+    cv_.wait_for(lock, page_cleaner_interval, [&] { return !running_ || woken_; });
+    if (!running_) {
+      return;
+    }
+    woken_ = false;
+    lock.unlock();
+    clean_();
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.cpp
+//
+// Identification: src/buffer/page_compressor.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_compressor.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+/** The last bytes are always literals, so a match never reads past the end of the input. */
+constexpr size_t LAST_LITERALS = 5;
+/** No match starts this close to the end of the input. */
+constexpr size_t MATCH_LIMIT = 12;
+constexpr size_t HASH_BITS = 12;
+constexpr size_t MAX_OFFSET = 65535;
+
+inline uint32_t Read32(const char *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline size_t Hash(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Writes the continuation bytes of a length whose nibble was 15. */
+inline void WriteLength(size_t length, char *dst, size_t *out) {
+  for (; length >= 255; length -= 255) {
+    dst[(*out)++] = static_cast<char>(255);
+  }
+  dst[(*out)++] = static_cast<char>(length);
+}
+
+/** Reads the continuation bytes of a length whose nibble was 15. */
+inline bool ReadLength(const unsigned char *src, size_t src_size, size_t *in, size_t *length) {
+  unsigned char byte;
+  do {
+    if (*in >= src_size) {
+      return false;
+    }
+    byte = src[(*in)++];
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/**
+ * Writes one sequence, or only literals if match_length is 0.
+ * @return false if it does not fit
+ */
+bool WriteSequence(const char *literals, size_t num_literals, size_t offset, size_t match_length, char *dst,
+                   size_t dst_capacity, size_t *out) {
+  // Token, literal length, literals, offset and match length, at their largest.
+  size_t worst = 1 + num_literals / 255 + 1 + num_literals + 2 + match_length / 255 + 1;
+  if (*out + worst > dst_capacity) {
+    return false;
+  }
+  size_t token_pos = (*out)++;
+  auto token = static_cast<unsigned char>((num_literals < 15 ? num_literals : 15) << 4);
+  if (num_literals >= 15) {
+    WriteLength(num_literals - 15, dst, out);
+  }
+  memcpy(dst + *out, literals, num_literals);
+  *out += num_literals;
+  if (match_length != 0) {
+    dst[(*out)++] = static_cast<char>(offset & 0xFF);
+    dst[(*out)++] = static_cast<char>(offset >> 8);
+    size_t length = match_length - MIN_MATCH;
+    token |= static_cast<unsigned char>(length < 15 ? length : 15);
+    if (length >= 15) {
+      WriteLength(length - 15, dst, out);
+    }
+  }
+  dst[token_pos] = static_cast<char>(token);
+  return true;
+}
+
+}  // namespace
+
+size_t PageCompressor::Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) {
+  // Positions plus one, so that zero means empty.
+  uint32_t table[1 << HASH_BITS] = {};
+  size_t out = 0;
+  size_t anchor = 0;
+  size_t pos = 0;
+  if (src_size > MATCH_LIMIT) {
+    while (pos < src_size - MATCH_LIMIT) {
+      uint32_t sequence = Read32(src + pos);
+      size_t hash = Hash(sequence);
+      size_t candidate = table[hash];
+      table[hash] = static_cast<uint32_t>(pos + 1);
+      if (candidate == 0 || pos + 1 - candidate > MAX_OFFSET || Read32(src + candidate - 1) != sequence) {
+        pos++;
+        continue;
+      }
+      candidate--;
+      size_t length = MIN_MATCH;
+      while (pos + length < src_size - LAST_LITERALS && src[candidate + length] == src[pos + length]) {
+        length++;
+      }
+      if (!WriteSequence(src + anchor, pos - anchor, pos - candidate, length, dst, dst_capacity, &out)) {
+        return 0;
+      }
+      pos += length;
+      anchor = pos;
+    }
+  }
+  if (!WriteSequence(src + anchor, src_size - anchor, 0, 0, dst, dst_capacity, &out)) {
+    return 0;
+  }
+  return out;
+}
+
+bool PageCompressor::Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) {
+  const auto *in_data = reinterpret_cast<const unsigned char *>(src);
+  size_t in = 0;
+  size_t out = 0;
+  while (in < src_size) {
+    unsigned char token = in_data[in++];
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !ReadLength(in_data, src_size, &in, &num_literals)) {
+      return false;
+    }
+    if (in + num_literals > src_size || out + num_literals > dst_size) {
+      return false;
+    }
+    memcpy(dst + out, src + in, num_literals);
+    in += num_literals;
+    out += num_literals;
+    if (in == src_size) {
+      break;
+    }
+
+    if (in + 2 > src_size) {
+      return false;
+    }
+    size_t offset = in_data[in] | (static_cast<size_t>(in_data[in + 1]) << 8);
+    in += 2;
+    size_t length = token & 0xF;
+    if (length == 15 && !ReadLength(in_data, src_size, &in, &length)) {
+      return false;
+    }
+    length += MIN_MATCH;
+    if (offset == 0 || offset > out || out + length > dst_size) {
+      return false;
+    }
+    // The match may overlap what it produces, e.g. a run of one byte has offset 1, so it is copied byte by byte.
+    for (size_t i = 0; i < length; i++, out++) {
+      dst[out] = dst[out - offset];
+    }
+  }
+  return out == dst_size;
+}
+
+}  // namespace bustub
@@ -0,0 +1,219 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerType replacer_type, size_t replacer_k, bool numa_aware,
+                                                     size_t max_pool_size)
+    : disk_manager_(disk_manager), prefetcher_([this](page_id_t page_id, const next_page_fn &next_page) {
+        return GetBufferPoolManager(page_id)->ReadAhead(page_id, next_page);
+      }) {
+  BUSTUB_ASSERT(num_instances > 0, "A parallel buffer pool needs at least one instance.");
+  instances_.reserve(num_instances);
+  int num_numa_nodes = numa_aware ? FrameArena::GetNumNumaNodes() : 1;
+  for (size_t i = 0; i < num_instances; i++) {
+    int numa_node = num_numa_nodes > 1 ? static_cast<int>(i % num_numa_nodes) : FrameArena::NO_NUMA_NODE;
+    instances_.push_back(new BufferPoolManagerInstance(pool_size, disk_manager, log_manager, replacer_type, replacer_k,
+                                                       numa_node, max_pool_size));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  prefetcher_.Stop();
+  for (auto *instance : instances_) {
+    delete instance;
+  }
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t pool_size = 0;
+  for (auto *instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+bool ParallelBufferPoolManager::Resize(size_t pool_size) {
+  size_t num_instances = instances_.size();
+  if (pool_size < num_instances) {
+    return false;
+  }
+  std::vector<size_t> old_sizes;
+  for (size_t i = 0; i < num_instances; i++) {
+    old_sizes.push_back(instances_[i]->GetPoolSize());
+    size_t instance_size = pool_size / num_instances + (i < pool_size % num_instances ? 1 : 0);
+    if (!instances_[i]->Resize(instance_size)) {
+      for (size_t j = 0; j < i; j++) {
+        // Growing back always succeeds, but shrinking back fails if pages were pinned in the new frames meanwhile.
+        if (!instances_[j]->Resize(old_sizes[j])) {
+          LOG_WARN("cannot put buffer pool instance %zu back to %zu frames, it keeps %zu", j, old_sizes[j],
+                   instances_[j]->GetPoolSize());
+        }
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParallelBufferPoolManager::SetCompressedTierCapacity(size_t capacity) {
+  for (auto *instance : instances_) {
+    instance->SetCompressedTierCapacity(capacity / instances_.size());
+  }
+}
+
+BufferPoolCounters ParallelBufferPoolManager::GetStats() {
+  BufferPoolCounters counters;
+  for (auto *instance : instances_) {
+    counters += instance->GetStats();
+  }
+  return counters;
+}
+
+void ParallelBufferPoolManager::ResetStats() {
+  for (auto *instance : instances_) {
+    instance->ResetStats();
+  }
+}
+
+void ParallelBufferPoolManager::SetHeatSampleRate(uint32_t sample_rate) {
+  for (auto *instance : instances_) {
+    instance->SetHeatSampleRate(sample_rate);
+  }
+}
+
+std::vector<std::pair<page_id_t, uint64_t>> ParallelBufferPoolManager::GetHottestPages(size_t max_pages) {
+  // A page only lives in one instance, but the merged histogram is needed to rank pages across instances.
+  std::unordered_map<page_id_t, uint64_t> heat;
+  for (auto *instance : instances_) {
+    instance->GetStatsCollector()->MergeHeat(&heat);
+  }
+  return BufferPoolStats::HottestPages(heat, max_pages);
+}
+
+BufferPoolManagerInstance *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()];
+}
+
+void ParallelBufferPoolManager::RunPageCleaner() {
+  for (auto *instance : instances_) {
+    instance->RunPageCleaner();
+  }
+}
+
+void ParallelBufferPoolManager::StopPageCleaner() {
+  for (auto *instance : instances_) {
+    instance->StopPageCleaner();
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::FetchPageWithStrategyImpl(page_id_t page_id, BufferAccessStrategy *strategy) {
+  return GetBufferPoolManager(page_id)->FetchPageWithStrategy(page_id, strategy);
+}
+
+bool ParallelBufferPoolManager::ReleasePageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->ReleasePage(page_id);
+}
+
+void ParallelBufferPoolManager::PrefetchPageImpl(page_id_t page_id, size_t depth, const next_page_fn &next_page) {
+  prefetcher_.Enqueue(page_id, depth, next_page);
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id) {
+  // Fresh page ids map to consecutive instances, but reused ones can map anywhere. Ids that land in a full instance
+  // are held on to until we are done, so that we keep getting new ones, and given back at the end. Instances that are
+  // full to begin with are not tried at all, and if all of them are, no id is allocated.
+  std::vector<bool> tried(instances_.size(), false);
+  size_t num_tried = 0;
+  for (size_t instance = 0; instance < instances_.size(); instance++) {
+    if (!instances_[instance]->HasFreeFrame()) {
+      tried[instance] = true;
+      num_tried++;
+    }
+  }
+  std::vector<page_id_t> rejected;
+  Page *page = nullptr;
+  *page_id = INVALID_PAGE_ID;
+  while (num_tried < instances_.size()) {
+    page_id_t new_page_id = disk_manager_->AllocatePage();
+    size_t instance = new_page_id % instances_.size();
+    if (!tried[instance]) {
+      page = instances_[instance]->NewPageWithId(new_page_id);
+      if (page != nullptr) {
+        *page_id = new_page_id;
+        break;
+      }
+      tried[instance] = true;
+      num_tried++;
+    }
+    rejected.push_back(new_page_id);
+  }
+  for (page_id_t rejected_page_id : rejected) {
+    disk_manager_->DeallocatePage(rejected_page_id);
+  }
+  return page;
+}
+
+Page *ParallelBufferPoolManager::NewPageInExtentImpl(page_id_t *page_id, PageExtent *extent) {
+  page_id_t new_page_id = extent->AllocatePage(disk_manager_);
+  Page *page = GetBufferPoolManager(new_page_id)->NewPageWithId(new_page_id);
+  if (page != nullptr) {
+    *page_id = new_page_id;
+    return page;
+  }
+  // The instance that owns the extent's next page is full. Rather than fail while others have room, give the page up
+  // and place the new page wherever there is a frame for it.
+  disk_manager_->DeallocatePage(new_page_id);
+  return NewPageImpl(page_id);
+}
+
+bool ParallelBufferPoolManager::DeletePageImpl(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPagesImpl() {
+  // Consecutive pages live in different instances, so the batch must span all of them to be coalesced.
+  std::vector<Page *> batch;
+  for (auto *instance : instances_) {
+    instance->CollectFlushBatch(&batch);
+  }
+  if (size_t failed = BufferPoolManagerInstance::WriteFlushBatch(disk_manager_, &batch); failed > 0) {
+    LOG_WARN("%zu of %zu pages could not be flushed, they stay dirty", failed, batch.size());
+  }
+  for (auto *instance : instances_) {
+    instance->ReleaseFlushBatch(batch);
+  }
+}
+
+}  // namespace bustub
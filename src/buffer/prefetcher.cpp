@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefetcher.cpp
+//
+// Identification: src/buffer/prefetcher.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/prefetcher.h"
+
+#include <utility>
+
+namespace bustub {
+
+Prefetcher::Prefetcher(read_ahead_fn read_ahead) : read_ahead_(std::move(read_ahead)) {}
+
+Prefetcher::~Prefetcher() { Stop(); }
+
+void Prefetcher::Enqueue(page_id_t page_id, size_t depth, BufferPoolManager::next_page_fn next_page) {
+  if (page_id == INVALID_PAGE_ID || depth == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (stopped_ || queue_.size() >= PREFETCH_QUEUE_SIZE) {
+      return;
+    }
+    queue_.push_back(Request{page_id, depth, std::move(next_page)});
+    if (!thread_.joinable()) {
+      thread_ = std::thread(&Prefetcher::Run, this);
+    }
+  }
+  cv_.notify_one();
+}
+
+void Prefetcher::WaitUntilIdle() {
+  std::unique_lock<std::mutex> lock(latch_);
+  idle_cv_.wait(lock, [&] { return stopped_ || (queue_.empty() && !busy_); });
+}
+
+void Prefetcher::Stop() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    stopped_ = true;
+    queue_.clear();
+  }
+  cv_.notify_one();
+  idle_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void Prefetcher::Run() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    cv_.wait(lock, [&] { return stopped_ || !queue_.empty(); });
+    if (stopped_) {
+      return;
+    }
+    Request request = std::move(queue_.front());
+    queue_.pop_front();
+    busy_ = true;
+    lock.unlock();
+
+    // Follow the chain without the latch so that scans can keep queueing requests while we wait on the disk.
+    page_id_t page_id = request.page_id_;
+    for (size_t i = 0; i < request.depth_ && page_id != INVALID_PAGE_ID; i++) {
+      bool last = i + 1 == request.depth_;
+      page_id = read_ahead_(page_id, last ? nullptr : request.next_page_);
+    }
+
+    lock.lock();
+    busy_ = false;
+    if (queue_.empty()) {
+      idle_cv_.notify_all();
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer.h"
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+Replacer *Replacer::Create(ReplacerType replacer_type, size_t num_pages, size_t k) {
+  switch (replacer_type) {
+    case ReplacerType::CLOCK:
+      return new ClockReplacer(num_pages);
+    case ReplacerType::LRU_K:
+      return new LRUKReplacer(num_pages, k);
+    case ReplacerType::TWO_QUEUE:
+      return new TwoQueueReplacer(num_pages);
+  }
+  UNREACHABLE("Unknown replacer type.");
+}
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark.cpp
+//
+// Identification: src/buffer/replacer_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer_benchmark.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+std::string ReplayResult::ToString(const std::string &policy) const {
+  std::stringstream os;
+  os << std::left << std::setw(8) << policy << std::right << " hit_ratio=" << std::fixed << std::setprecision(4)
+     << HitRatio() << " throughput=" << std::setprecision(0) << throughput_ << "/s p50=" << p50_ns_
+     << "ns p99=" << p99_ns_ << "ns p99.9=" << p999_ns_ << "ns max=" << max_ns_ << "ns";
+  return os.str();
+}
+
+ReplayResult ReplacerBenchmark::Replay(const AccessTrace &trace, Replacer *replacer, size_t num_frames) {
+  // A pool without frames has nowhere to put a page, and no victim to take one from.
+  if (num_frames == 0) {
+    return {};
+  }
+  const auto &accesses = trace.GetAccesses();
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frames(num_frames, INVALID_PAGE_ID);
+  size_t next_free_frame = 0;
+  std::vector<uint64_t> latencies;
+  latencies.reserve(accesses.size());
+
+  ReplayResult result;
+  std::chrono::nanoseconds total{0};
+  for (page_id_t page_id : accesses) {
+    auto start = std::chrono::steady_clock::now();
+    frame_id_t frame_id;
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      frame_id = it->second;
+      result.hits_++;
+    } else if (next_free_frame < num_frames) {
+      frame_id = static_cast<frame_id_t>(next_free_frame++);
+      page_table[page_id] = frame_id;
+    } else {
+      // Every frame is unpinned between accesses, so there is always a victim.
+      [[maybe_unused]] bool found = replacer->Victim(&frame_id);
+      BUSTUB_ASSERT(found, "The replacer has no victim.");
+      replacer->Remove(frame_id);
+      page_table.erase(frames[frame_id]);
+      page_table[page_id] = frame_id;
+    }
+    frames[frame_id] = page_id;
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+    auto latency = std::chrono::steady_clock::now() - start;
+    total += latency;
+    latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+  }
+
+  result.accesses_ = accesses.size();
+  if (latencies.empty()) {
+    return result;
+  }
+  result.throughput_ = static_cast<double>(result.accesses_) / std::chrono::duration<double>(total).count();
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double fraction) {
+    return latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))];
+  };
+  result.p50_ns_ = percentile(0.5);
+  result.p99_ns_ = percentile(0.99);
+  result.p999_ns_ = percentile(0.999);
+  result.max_ns_ = latencies.back();
+  return result;
+}
+
+std::string ReplacerBenchmark::PolicyName(ReplacerType replacer_type) {
+  switch (replacer_type) {
+    case ReplacerType::CLOCK:
+      return "clock";
+    case ReplacerType::LRU_K:
+      return "lru-k";
+    case ReplacerType::TWO_QUEUE:
+      return "2q";
+  }
+  UNREACHABLE("Unknown replacer type.");
+}
+
+}  // namespace bustub
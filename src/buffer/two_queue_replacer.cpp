@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_pages, size_t correlated_period)
+    : a1_threshold_(std::max<size_t>(num_pages / 4, 1)), correlated_period_(correlated_period), frames_(num_pages) {}
+
+TwoQueueReplacer::~TwoQueueReplacer() = default;
+
+bool TwoQueueReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  bool from_a1 = (a1_size_ > a1_threshold_ && !a1_.empty()) || am_.empty();
+  auto &from = from_a1 ? a1_ : am_;
+  if (from.empty()) {
+    return false;
+  }
+  *frame_id = from.begin()->second;
+  from.erase(from.begin());
+  // The frame stays tracked until the caller confirms the eviction with Remove, so that a page pinned again before the
+  // caller can claim the frame keeps its place in A1 or Am. Meanwhile it does not count towards A1.
+  QueueFrame &frame = frames_[*frame_id];
+  frame.evictable_ = false;
+  frame.victim_ = true;
+  if (!frame.in_am_) {
+    a1_size_--;
+  }
+  return true;
+}
+
+void TwoQueueReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  MakeUnevictable(frame_id);
+  KeepVictim(frame_id);
+  QueueFrame &frame = frames_[frame_id];
+  if (!frame.tracked_) {
+    Track(frame_id);
+  } else if (!frame.in_am_ && current_timestamp_ - frame.last_access_ >= correlated_period_) {
+    // Second access, past the correlated reference period of the first: the page has proven it is reused.
+    frame.in_am_ = true;
+    a1_size_--;
+  }
+  frame.last_access_ = current_timestamp_++;
+}
+
+void TwoQueueReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  QueueFrame &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    return;
+  }
+  KeepVictim(frame_id);
+  if (!frame.tracked_) {
+    Track(frame_id);
+  }
+  frame.evictable_ = true;
+  if (frame.in_am_) {
+    am_.emplace(frame.last_access_, frame_id);
+  } else {
+    a1_.emplace(frame.first_access_, frame_id);
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  MakeUnevictable(frame_id);
+  Untrack(frame_id);
+}
+
+std::vector<frame_id_t> TwoQueueReplacer::ColdFrames(size_t max_frames) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // Approximates the order of successive victims by assuming A1 stays over or under its threshold.
+  bool a1_first = a1_size_ > a1_threshold_;
+  std::vector<frame_id_t> frames;
+  for (const auto *from : {a1_first ? &a1_ : &am_, a1_first ? &am_ : &a1_}) {
+    for (auto it = from->begin(); it != from->end() && frames.size() < max_frames; ++it) {
+      frames.push_back(it->second);
+    }
+  }
+  return frames;
+}
+
+size_t TwoQueueReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return a1_.size() + am_.size();
+}
+
+void TwoQueueReplacer::Track(frame_id_t frame_id) {
+  QueueFrame &frame = frames_[frame_id];
+  frame.tracked_ = true;
+  frame.in_am_ = false;
+  frame.first_access_ = current_timestamp_;
+  frame.last_access_ = current_timestamp_;
+  a1_size_++;
+}
+
+void TwoQueueReplacer::Untrack(frame_id_t frame_id) {
+  QueueFrame &frame = frames_[frame_id];
+  if (frame.tracked_ && !frame.in_am_ && !frame.victim_) {
+    a1_size_--;
+  }
+  frame = QueueFrame{};
+}
+
+void TwoQueueReplacer::KeepVictim(frame_id_t frame_id) {
+  QueueFrame &frame = frames_[frame_id];
+  if (!frame.victim_) {
+    return;
+  }
+  frame.victim_ = false;
+  if (!frame.in_am_) {
+    a1_size_++;
+  }
+}
+
+void TwoQueueReplacer::MakeUnevictable(frame_id_t frame_id) {
+  QueueFrame &frame = frames_[frame_id];
+  if (!frame.evictable_) {
+    return;
+  }
+  frame.evictable_ = false;
+  if (frame.in_am_) {
+    am_.erase({frame.last_access_, frame_id});
+  } else {
+    a1_.erase({frame.first_access_, frame_id});
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bustub_config.cpp
+//
+// Identification: src/common/bustub_config.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/bustub_config.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "common/logger.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+namespace {
+
+/** Reads a positive number from an environment variable into value, which is left alone if there is none. */
+void ReadSize(const char *name, size_t *value) {
+  const char *text = std::getenv(name);
+  if (text == nullptr) {
+    return;
+  }
+  char *end;
+  uint64_t parsed = std::strtoull(text, &end, 10);
+  if (end == text || *end != '\0' || parsed == 0) {
+    LOG_WARN("ignoring %s=%s, expected a positive number", name, text);
+    return;
+  }
+  *value = parsed;
+}
+
+/** Reads a 0 or 1 from an environment variable into value, which is left alone if there is none. */
+void ReadFlag(const char *name, bool *value) {
+  const char *text = std::getenv(name);
+  if (text == nullptr) {
+    return;
+  }
+  std::string flag(text);
+  if (flag != "0" && flag != "1") {
+    LOG_WARN("ignoring %s=%s, expected 0 or 1", name, text);
+    return;
+  }
+  *value = flag == "1";
+}
+
+}  // namespace
+
+BustubConfig BustubConfig::FromEnvironment() {
+  BustubConfig config;
+  ReadSize("BUSTUB_PAGE_SIZE", &config.page_size_);
+  if (!DiskManager::IsValidPageSize(config.page_size_)) {
+    LOG_WARN("ignoring BUSTUB_PAGE_SIZE=%zu, expected a power of two between %d and %d", config.page_size_,
+             MIN_PAGE_SIZE, MAX_PAGE_SIZE);
+    config.page_size_ = PAGE_SIZE;
+  }
+  ReadSize("BUSTUB_BUFFER_POOL_SIZE", &config.buffer_pool_size_);
+  ReadSize("BUSTUB_MAX_BUFFER_POOL_SIZE", &config.max_buffer_pool_size_);
+  ReadSize("BUSTUB_COMPRESSED_TIER_SIZE", &config.compressed_tier_size_);
+  ReadSize("BUSTUB_LOG_BUFFER_SIZE", &config.log_buffer_size_);
+  ReadSize("BUSTUB_REPLACER_K", &config.replacer_k_);
+  if (const char *stripe_files = std::getenv("BUSTUB_STRIPE_FILES"); stripe_files != nullptr) {
+    std::string paths(stripe_files);
+    for (size_t start = 0; start <= paths.size();) {
+      size_t end = std::min(paths.find(',', start), paths.size());
+      if (end > start) {
+        config.stripe_files_.push_back(paths.substr(start, end - start));
+      }
+      start = end + 1;
+    }
+  }
+  ReadFlag("BUSTUB_DIRECT_IO", &config.direct_io_);
+  ReadFlag("BUSTUB_MMAP_READS", &config.mmap_reads_);
+  if (const char *replacer = std::getenv("BUSTUB_REPLACER"); replacer != nullptr) {
+    std::string name(replacer);
+    if (name == "clock") {
+      config.replacer_type_ = ReplacerType::CLOCK;
+    } else if (name == "lru-k") {
+      config.replacer_type_ = ReplacerType::LRU_K;
+    } else if (name == "2q") {
+      config.replacer_type_ = ReplacerType::TWO_QUEUE;
+    } else {
+      LOG_WARN("ignoring BUSTUB_REPLACER=%s, expected clock, lru-k or 2q", replacer);
+    }
+  }
+  return config;
+}
+
+}  // namespace bustub
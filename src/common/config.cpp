@@ -18,6 +18,8 @@ std::atomic<bool> enable_logging(false);
 
 std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
+std::chrono::milliseconds page_cleaner_interval = std::chrono::milliseconds(100);
+
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
 }  // namespace bustub
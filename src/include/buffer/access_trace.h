@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.h
+//
+// Identification: src/include/buffer/access_trace.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * AccessTrace is the sequence of pages a workload fetched from a buffer pool, so that it can be replayed against other
+ * replacement policies with ReplacerBenchmark.
+ *
+ * A trace is recorded through the grading callback of BufferPoolManager::FetchPage: pass AccessTrace::RecordCallback
+ * as the callback while a trace is being recorded, and every fetch is appended to it. The callback is a plain function
+ * pointer, so only one trace can be recorded at a time.
+ */
+class AccessTrace {
+ public:
+  AccessTrace() = default;
+
+  /** @param accesses the pages accessed, in order */
+  explicit AccessTrace(std::vector<page_id_t> accesses) : accesses_(std::move(accesses)) {}
+
+  /** Appends an access to the trace. Thread-safe. */
+  void Append(page_id_t page_id) {
+    std::lock_guard<std::mutex> guard(latch_);
+    accesses_.push_back(page_id);
+  }
+
+  /** @return the pages accessed, in order */
+  const std::vector<page_id_t> &GetAccesses() const { return accesses_; }
+
+  /**
+   * Writes the trace to a file, one page id per line.
+   * @return false if the file could not be written
+   */
+  bool Save(const std::string &file_name) const;
+
+  /**
+   * Reads a trace written by Save.
+   * @param file_name the file to read
+   * @param[out] trace the trace, replaced by what was read
+   * @return false if the file could not be read or is malformed
+   */
+  static bool Load(const std::string &file_name, AccessTrace *trace);
+
+  /** Makes RecordCallback append to the given trace, or to nothing if it is nullptr. */
+  static void StartRecording(AccessTrace *trace);
+
+  /** Stops recording. */
+  static void StopRecording() { StartRecording(nullptr); }
+
+  /** A BufferPoolManager::bufferpool_callback_fn that records the page of each fetch into the current trace. */
+  static void RecordCallback(BufferPoolManager::CallbackType callback_type, page_id_t page_id);
+
+ private:
+  std::mutex latch_;
+  std::vector<page_id_t> accesses_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * BufferAccessStrategy gives a large scan a small private ring of frames to recycle, so that it does not push the
+ * working set of everybody else out of the buffer pool.
+ *
+ * The strategy remembers the last ring_size pages that its scan had to read in. When the scan reads in yet another
+ * page, the oldest page of the ring is released: if nobody else has it pinned, it is written back if dirty and its
+ * frame goes straight to the front of the free list, where the scan's next miss picks it up. Pages the scan finds
+ * already resident are left alone, since somebody else is probably using them.
+ *
+ * A strategy belongs to a single scan and is not thread-safe.
+ */
+class BufferAccessStrategy {
+ public:
+  /**
+   * Creates a new ring.
+   * @param bpm the buffer pool the scan reads through
+   * @param ring_size the number of pages the scan may keep in the pool at once
+   */
+  explicit BufferAccessStrategy(BufferPoolManager *bpm, size_t ring_size = SCAN_RING_SIZE);
+
+  ~BufferAccessStrategy() = default;
+
+  DISALLOW_COPY_AND_MOVE(BufferAccessStrategy);
+
+  /**
+   * Records that the scan read a page into the pool, releasing the oldest page of the ring if it is full. Called by
+   * the buffer pool after the page is loaded, without holding any buffer pool latch.
+   * @param page_id the page that was read in
+   */
+  void OnPageLoaded(page_id_t page_id);
+
+  /** @return the number of pages this strategy released back to the free list */
+  size_t GetNumReleased() const { return num_released_; }
+
+ private:
+  /** The buffer pool the ring belongs to. */
+  BufferPoolManager *bpm_;
+  /** Pages the scan read in, used as a circular buffer. */
+  std::vector<page_id_t> ring_;
+  /** Next slot of the ring to overwrite. */
+  size_t next_{0};
+  /** Number of pages released so far. */
+  size_t num_released_{0};
+};
+
+}  // namespace bustub
@@ -12,37 +12,39 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
-#include <unordered_map>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
 
-#include "buffer/clock_replacer.h"
-#include "recovery/log_manager.h"
-#include "storage/disk/disk_manager.h"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_stats.h"
+#include "common/config.h"
+#include "storage/disk/page_extent.h"
 #include "storage/page/page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * This is the interface shared by every buffer pool implementation. Components such as TableHeap, the hash table and
+ * the executors only ever talk to a BufferPoolManager *, so any implementation can be dropped in underneath them.
  */
 class BufferPoolManager {
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
+  /** Given a pinned page, returns the id of the page that follows it in its chain, or INVALID_PAGE_ID. */
+  using next_page_fn = std::function<page_id_t(Page *page)>;
 
-  /**
-   * Creates a new BufferPoolManager.
-   * @param pool_size the size of the buffer pool
-   * @param disk_manager the disk manager
-   * @param log_manager the log manager (for testing only: nullptr = disable logging)
-   */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager() = default;
 
   /**
    * Destroys an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager() = default;
 
   /** Grading function. Do not modify! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
@@ -91,13 +93,124 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
-  /** @return pointer to all the pages in the buffer pool */
-  Page *GetPages() { return pages_; }
+  /**
+   * Fetches a page wrapped in a guard that unpins it when the guard goes out of scope.
+   * @param page_id id of page to be fetched
+   * @return the guard, empty if every frame is pinned
+   */
+  BasicPageGuard FetchPageBasic(page_id_t page_id) { return {this, FetchPage(page_id)}; }
+
+  /**
+   * Fetches a page and takes its read latch, wrapped in a guard that releases both when it goes out of scope.
+   * @param page_id id of page to be fetched
+   * @return the guard, empty if every frame is pinned
+   */
+  ReadPageGuard FetchPageRead(page_id_t page_id) {
+    Page *page = FetchPage(page_id);
+    if (page != nullptr) {
+      page->RLatch();
+    }
+    return {this, page};
+  }
+
+  /**
+   * Fetches a page and takes its write latch, wrapped in a guard that releases both when it goes out of scope.
+   * @param page_id id of page to be fetched
+   * @return the guard, empty if every frame is pinned
+   */
+  WritePageGuard FetchPageWrite(page_id_t page_id) {
+    Page *page = FetchPage(page_id);
+    if (page != nullptr) {
+      page->WLatch();
+    }
+    return {this, page};
+  }
+
+  /**
+   * Creates a new page wrapped in a guard that unpins it when the guard goes out of scope.
+   * @param[out] page_id id of created page, INVALID_PAGE_ID if none was created
+   * @return the guard, empty if no new page could be created
+   */
+  BasicPageGuard NewPageGuarded(page_id_t *page_id) { return {this, NewPage(page_id)}; }
+
+  /**
+   * Creates a new page in the given extent rather than wherever the disk manager would put it, so that the pages of a
+   * table heap or index end up next to each other on disk.
+   * @param[out] page_id id of created page, INVALID_PAGE_ID if none was created
+   * @param extent the extent of the table heap or index the page belongs to
+   * @return nullptr if no new page could be created, otherwise pointer to new page
+   */
+  Page *NewPageInExtent(page_id_t *page_id, PageExtent *extent) { return NewPageInExtentImpl(page_id, extent); }
+
+  /**
+   * Fetches a page on behalf of a scan that recycles its own ring of frames. Pages that have to be read in are
+   * recorded in the strategy, which releases the oldest of them once the ring is full.
+   * @param page_id id of page to be fetched
+   * @param strategy the scan's ring, or nullptr to behave like FetchPage
+   * @return the requested page, pinned, or nullptr if every frame is pinned
+   */
+  Page *FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) {
+    return FetchPageWithStrategyImpl(page_id, strategy);
+  }
+
+  /**
+   * Evicts a page right away if it is resident and unpinned, writing it back if it is dirty. Its frame goes to the
+   * front of the free list so that it is the next one to be reused.
+   * @param page_id id of page to be released
+   * @return true if the page was evicted, false if it was not resident or is pinned
+   */
+  bool ReleasePage(page_id_t page_id) { return ReleasePageImpl(page_id); }
+
+  /**
+   * Asks for pages to be read into the pool in the background, and returns right away. Read-ahead pages are left
+   * unpinned, so a later FetchPage finds them resident. Requests may be dropped if the background thread falls behind.
+   * @param page_id id of the first page to read ahead, INVALID_PAGE_ID is ignored
+   * @param depth number of pages to read ahead, following next_page from one page to the next
+   * @param next_page returns the page that follows a read-ahead page; only needed if depth > 1
+   */
+  void PrefetchPage(page_id_t page_id, size_t depth = 1, const next_page_fn &next_page = nullptr) {
+    PrefetchPageImpl(page_id, depth, next_page);
+  }
 
   /** @return size of the buffer pool */
-  size_t GetPoolSize() { return pool_size_; }
+  virtual size_t GetPoolSize() = 0;
+
+  /** @return the size of the pages the pool holds, which is the page size of the file it caches */
+  virtual size_t GetPageSize() = 0;
+
+  /**
+   * Grows or shrinks the buffer pool without restarting it.
+   * @param pool_size the new size of the buffer pool
+   * @return false if the pool could not be resized, e.g. because pages that would go away are pinned
+   */
+  virtual bool Resize(size_t pool_size) = 0;
+
+  /**
+   * Sets the size of the compressed tier, where clean pages evicted from the pool are kept compressed so that a later
+   * miss on them does not have to read the disk. The tier is off by default. Changing its size empties it.
+   * @param capacity the memory the compressed pages may take up, in bytes, 0 turns the tier off
+   */
+  virtual void SetCompressedTierCapacity(size_t capacity) = 0;
+
+  /** @return the hit, miss, eviction and write counters of the buffer pool */
+  virtual BufferPoolCounters GetStats() = 0;
+
+  /** Sets every counter back to zero and forgets the page heat. */
+  virtual void ResetStats() = 0;
+
+  /**
+   * Turns sampling of per-page access counts on or off. Sampling is off by default.
+   * @param sample_rate count one fetch in this many, 0 turns sampling off
+   */
+  virtual void SetHeatSampleRate(uint32_t sample_rate) = 0;
+
+  /**
+   * @param max_pages the number of pages to return
+   * @return the pages fetched most often while heat sampling was on, with their number of samples, hottest first
+   */
+  virtual std::vector<std::pair<page_id_t, uint64_t>> GetHottestPages(size_t max_pages) = 0;
 
- private:
+ protected:
   /**
    * Grading function. Do not modify!
    * Invokes the callback function if it is not null.
@@ -116,7 +229,30 @@ class BufferPoolManager {
    * @param page_id id of page to be fetched
    * @return the requested page
    */
-  Page *FetchPageImpl(page_id_t page_id);
+  virtual Page *FetchPageImpl(page_id_t page_id) = 0;
+
+  /**
+   * Fetch the requested page from the buffer pool, recording it in the strategy if it has to be read in.
+   * @param page_id id of page to be fetched
+   * @param strategy the scan's ring, may be nullptr
+   * @return the requested page
+   */
+  virtual Page *FetchPageWithStrategyImpl(page_id_t page_id, BufferAccessStrategy *strategy) = 0;
+
+  /**
+   * Evicts an unpinned page and puts its frame at the front of the free list.
+   * @param page_id id of page to be released
+   * @return true if the page was evicted
+   */
+  virtual bool ReleasePageImpl(page_id_t page_id) = 0;
+
+  /**
+   * Queues pages to be read into the pool by a background thread.
+   * @param page_id id of the first page to read ahead
+   * @param depth number of pages to read ahead
+   * @param next_page returns the page that follows a read-ahead page
+   */
+  virtual void PrefetchPageImpl(page_id_t page_id, size_t depth, const next_page_fn &next_page) = 0;
 
   /**
    * Unpin the target page from the buffer pool.
@@ -124,49 +260,41 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPageImpl(page_id_t page_id, bool is_dirty) = 0;
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id);
+  virtual bool FlushPageImpl(page_id_t page_id) = 0;
 
   /**
    * Creates a new page in the buffer pool.
-   * @param[out] page_id id of created page
+   * @param[out] page_id id of created page, INVALID_PAGE_ID if none was created
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual Page *NewPageImpl(page_id_t *page_id) = 0;
+
+  /**
+   * Creates a new page in the buffer pool, allocated from an extent.
+   * @param[out] page_id id of created page, INVALID_PAGE_ID if none was created
+   * @param extent the extent to allocate the page from
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id);
+  virtual Page *NewPageInExtentImpl(page_id_t *page_id, PageExtent *extent) = 0;
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id);
+  virtual bool DeletePageImpl(page_id_t page_id) = 0;
 
   /**
    * Flushes all the pages in the buffer pool to disk.
    */
-  void FlushAllPagesImpl();
-
-  /** Number of pages in the buffer pool. */
-  size_t pool_size_;
-  /** Array of buffer pool pages. */
-  Page *pages_;
-  /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  /** Pointer to the log manager. */
-  LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  Replacer *replacer_;
-  /** List of free pages. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  virtual void FlushAllPagesImpl() = 0;
 };
+
 }  // namespace bustub
@@ -0,0 +1,292 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.h
+//
+// Identification: src/include/buffer/buffer_pool_manager_instance.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lock_free_page_table.h"
+#include "buffer/page_cleaner.h"
+#include "buffer/prefetcher.h"
+#include "buffer/replacer.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * BufferPoolManagerInstance is a single buffer pool: one array of frames with its own page table, free list, replacer
+ * and latch. It can be used on its own, or as one of the shards of a ParallelBufferPoolManager.
+ *
+ * Fetching a page that is already resident does not take the latch: the page table supports lock-free lookups and
+ * the page is pinned with a compare-and-swap on its pin count. Unpinning does not take it either, and only hands the
+ * frame to the replacer when the last pin is dropped. Only misses, new pages, deletions and evictions go through the
+ * latch. An eviction claims its victim by swapping the pin count from 0 to FRAME_EXCLUSIVE, so it can
+ * never race with a lock-free pin.
+ *
+ * Pages can also be read ahead by a background Prefetcher. A read-ahead page is loaded unpinned and without counting
+ * as an access for the replacer; the first fetch that finds it counts as its first access.
+ *
+ * Once RunPageCleaner is called, a background PageCleaner writes back the dirty pages at the cold end of the replacer,
+ * so that evictions seldom have to write back a victim themselves.
+ *
+ * Evicted pages can be kept compressed in memory, in a CompressedPageCache sized with SetCompressedTierCapacity; misses
+ * look there before reading the disk.
+ *
+ * The pool can be resized online, up to the maximum size it was created with. Everything that depends on the number
+ * of frames (the arena, the frame metadata, the page table and the replacer) is sized for the maximum up front, so
+ * frames never move and lock-free lookups stay valid; growing only hands more frames to the free list, and shrinking
+ * retires the highest frames and gives their memory back to the system.
+ *
+ * Frames are the size of the pages of the disk manager's file. A database with files of several page sizes, e.g. large
+ * pages for scanned tables and small ones for index blocks, gets one instance per file, so each page size has a frame
+ * pool of its own and no frame is ever larger than the pages it holds.
+ */
+class BufferPoolManagerInstance : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new BufferPoolManagerInstance.
+   * @param pool_size the size of the buffer pool
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used to pick victims
+   * @param replacer_k the lookback window of the LRU-K replacer, ignored by the other policies
+   * @param numa_node the NUMA node to allocate the frames on, or FrameArena::NO_NUMA_NODE
+   * @param max_pool_size the size Resize may grow the pool to, 0 if it should never grow beyond pool_size
+   */
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::CLOCK, size_t replacer_k = LRUK_REPLACER_K,
+                            int numa_node = FrameArena::NO_NUMA_NODE, size_t max_pool_size = 0);
+
+  /**
+   * Destroys an existing BufferPoolManagerInstance.
+   */
+  ~BufferPoolManagerInstance() override;
+
+  /** @return pointer to all the pages in the buffer pool */
+  Page *GetPages() { return pages_; }
+
+  /** @return size of the buffer pool */
+  size_t GetPoolSize() override { return pool_size_.load(std::memory_order_acquire); }
+
+  size_t GetPageSize() override { return arena_.GetFrameSize(); }
+
+  /** @return the size the pool can be grown to */
+  size_t GetMaxPoolSize() const { return max_pool_size_; }
+
+  /**
+   * Grows or shrinks the pool. Shrinking evicts the pages in the frames that go away, writing back the dirty ones, so
+   * it fails if any of those pages is pinned.
+   * @param pool_size the new number of frames, between 1 and GetMaxPoolSize()
+   * @return false if the pool was left unchanged
+   */
+  bool Resize(size_t pool_size) override;
+
+  void SetCompressedTierCapacity(size_t capacity) override;
+
+  BufferPoolCounters GetStats() override { return stats_.GetCounters(); }
+
+  void ResetStats() override { stats_.Reset(); }
+
+  void SetHeatSampleRate(uint32_t sample_rate) override { stats_.SetHeatSampleRate(sample_rate); }
+
+  std::vector<std::pair<page_id_t, uint64_t>> GetHottestPages(size_t max_pages) override {
+    return stats_.GetHottestPages(max_pages);
+  }
+
+  /** @return the counters of this instance, e.g. to merge the page heat of several instances */
+  BufferPoolStats *GetStatsCollector() { return &stats_; }
+
+  /**
+   * Tells whether a new page could get a frame, so that callers need not allocate a page id only to give it back.
+   * @return true if a frame is free or holds an unpinned page; a concurrent fetch may take it before it is used
+   */
+  bool HasFreeFrame();
+
+  /**
+   * Creates a page with an id that has already been allocated on disk by the caller. This is how the
+   * ParallelBufferPoolManager places a new page in the shard that owns its id.
+   * @param page_id id of the page to create, must not be resident already
+   * @return nullptr if all the frames are pinned, otherwise pointer to the new, pinned and zeroed page
+   */
+  Page *NewPageWithId(page_id_t page_id);
+
+  /**
+   * Synchronously reads a page into the pool without pinning it, unless it is resident already. This is the work a
+   * Prefetcher does for PrefetchPage; a ParallelBufferPoolManager calls it on the instance that owns each page.
+   * @param page_id id of the page to read
+   * @param next_page if not empty, called on the pinned page to find the next one to read ahead
+   * @return the page that follows, or INVALID_PAGE_ID if next_page is empty or the page could not be loaded
+   */
+  page_id_t ReadAhead(page_id_t page_id, const next_page_fn &next_page);
+
+  /** Starts the background page cleaner. */
+  void RunPageCleaner() { page_cleaner_.Run(); }
+
+  /** Stops the background page cleaner. */
+  void StopPageCleaner() { page_cleaner_.Stop(); }
+
+  /**
+   * Writes back the dirty, unpinned pages among the next frames the replacer would evict. This is one pass of the page
+   * cleaner. The writes are all started asynchronously before the first is waited for, so the whole batch is in
+   * flight at once. A page is skipped if its log records have not been flushed yet, so the write-ahead rule is never
+   * broken. While a page is being written it is pinned, so it cannot be evicted or deleted.
+   * @param max_pages the number of cold frames to look at
+   * @return the number of pages written back
+   */
+  size_t CleanColdPages(size_t max_pages = PAGE_CLEANER_BATCH);
+
+  /**
+   * Adds every resident page that may differ from disk, i.e. that is dirty or pinned, to a batch for WriteFlushBatch.
+   * The pages are pinned so that they stay put while the batch is written without the latch; the caller must give the
+   * pins back with ReleaseFlushBatch.
+   * @param[out] batch the batch to add the pages to
+   */
+  void CollectFlushBatch(std::vector<Page *> *batch);
+
+  /**
+   * Writes a batch of pinned pages, possibly of several instances that share a disk manager, in page id order with
+   * DiskManager::WritePages. Each page is copied under its read latch and its dirty flag cleared, so a page that is
+   * being changed is never written torn; the copies are written FLUSH_CHUNK_PAGES at a time. Pages that could not be
+   * written are marked dirty again. Must not be called while holding the write latch of a page.
+   * @param disk_manager the disk manager of the pages
+   * @param batch the batch, which is sorted by page id
+   * @return the number of pages that could not be written
+   */
+  static size_t WriteFlushBatch(DiskManager *disk_manager, std::vector<Page *> *batch);
+
+  /**
+   * Unpins the pages CollectFlushBatch added to a batch. Pages of other instances in the batch are ignored.
+   * @param batch the written batch
+   */
+  void ReleaseFlushBatch(const std::vector<Page *> &batch);
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id) override;
+
+  Page *FetchPageWithStrategyImpl(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  bool ReleasePageImpl(page_id_t page_id) override;
+
+  void PrefetchPageImpl(page_id_t page_id, size_t depth, const next_page_fn &next_page) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  /** Writes the page under its read latch, so it must not be called while holding a latch of the page. */
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  Page *NewPageInExtentImpl(page_id_t *page_id, PageExtent *extent) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  /** Writes all the pages that may differ from disk as one batch, in page id order; see WriteFlushBatch. */
+  void FlushAllPagesImpl() override;
+
+ private:
+  /**
+   * Pins a page found through a lock-free page table lookup, without taking the latch.
+   * @param frame_id the frame the page table pointed to
+   * @param page_id the page that is expected to be in the frame
+   * @param record_access false to leave the replacer untouched, e.g. when only reading ahead
+   * @return false if the frame is held exclusively or now holds a different page; the caller must take the slow path
+   */
+  bool TryPinResident(frame_id_t frame_id, page_id_t page_id, bool record_access = true);
+
+  /**
+   * Drops one pin from a frame and hands the frame to the replacer once nobody has it pinned.
+   * @return false if the frame was not pinned
+   */
+  bool DecrementPin(frame_id_t frame_id);
+
+  /**
+   * Finds a frame to hold a new page, either from the free list or by evicting the replacer's victim. A dirty victim
+   * is written back and removed from the page table. Must be called with latch_ held. The frame is returned held
+   * exclusively (pin count FRAME_EXCLUSIVE), so it cannot be pinned until the caller publishes a new pin count.
+   * @param[out] frame_id the frame that can now be reused
+   * @return false if every frame is pinned
+   */
+  bool AcquireFrame(frame_id_t *frame_id);
+
+  /**
+   * Starts writing back the page in a frame if it is dirty, unpinned and its log records are persistent. The page stays
+   * pinned and read-latched until the asynchronous write completes.
+   * @param frame_id the frame to clean
+   * @param on_written called on a disk manager thread once the write has completed and the page is released
+   * @return true if a write was started, in which case on_written will be called
+   */
+  bool CleanFrame(frame_id_t frame_id, const std::function<void()> &on_written);
+
+  /**
+   * Reads a page into a frame that is held exclusively, from the compressed tier if it is there and otherwise from
+   * disk. Must be called with latch_ held.
+   */
+  void ReadFrame(page_id_t page_id, Page *page);
+
+  /**
+   * Writes the page held in the given frame to disk and clears its dirty flag. Must be called with latch_ held and the
+   * frame held exclusively, or with the page pinned and read-latched.
+   */
+  void WriteBackFrame(frame_id_t frame_id);
+
+  /** Pin count of a frame that is free, or is being evicted, loaded or deleted. */
+  static constexpr int FRAME_EXCLUSIVE = -1;
+
+  /** Number of pages WriteFlushBatch copies and writes at a time. */
+  static constexpr size_t FLUSH_CHUNK_PAGES = 64;
+
+  /** Number of pages in the buffer pool. Frames from pool_size_ up to max_pool_size_ are retired. */
+  std::atomic<size_t> pool_size_;
+  /** Number of frames the pool has room for. */
+  size_t max_pool_size_;
+  /** Page data of the frames. */
+  FrameArena arena_;
+  /** Array of buffer pool pages, i.e. the frames' metadata. Their data lives in arena_. */
+  Page *pages_;
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** Pointer to the log manager. */
+  LogManager *log_manager_;
+  /** Page table for keeping track of buffer pool pages. Readable without the latch, written only under it. */
+  LockFreePageTable page_table_;
+  /** Replacer to find unpinned pages for replacement. */
+  Replacer *replacer_;
+  /** List of free pages. */
+  std::list<frame_id_t> free_list_;
+  /**
+   * This latch serializes writers of page_table_ and free_list_, and protects frame metadata other than the pin count
+   * and the dirty flag. Resident pages are pinned and unpinned without it.
+   */
+  std::mutex latch_;
+  /** Compressed copies of evicted pages, nullptr if the tier is off. Protected by latch_. */
+  std::unique_ptr<CompressedPageCache> compressed_tier_;
+  /** Counters and page heat. */
+  BufferPoolStats stats_;
+  /** Background reader for PrefetchPage. Its thread only starts with the first request. */
+  Prefetcher prefetcher_;
+  /** Background writer for dirty cold pages. Only runs once RunPageCleaner is called. */
+  PageCleaner page_cleaner_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** A point-in-time copy of the counters of one or more buffer pools. */
+struct BufferPoolCounters {
+  /** Fetches that found their page resident. */
+  uint64_t hits_{0};
+  /** Fetches that had to read their page from disk. */
+  uint64_t misses_{0};
+  /** Pages evicted to make room for another one. */
+  uint64_t evictions_{0};
+  /** Evicted pages that had to be written back first, on the evicting thread. */
+  uint64_t dirty_evictions_{0};
+  /** Pages written to disk, for whatever reason. */
+  uint64_t page_writes_{0};
+  /** Pages written back by the page cleaner. */
+  uint64_t cleaner_writes_{0};
+  /** Pages read in ahead of time by the prefetcher. */
+  uint64_t prefetches_{0};
+  /** Misses served from the compressed tier instead of the disk. */
+  uint64_t compressed_hits_{0};
+  /**
+   * Total time fetches spent on the slow path, i.e. everything after the lock-free lookup failed: waiting for the
+   * latch, picking a victim, writing back a dirty one and reading the page in.
+   */
+  uint64_t slow_path_ns_{0};
+
+  /** @return the fraction of fetches that were hits, 0 if there were none */
+  double HitRate() const;
+
+  /** Adds the counters of another buffer pool to these. */
+  BufferPoolCounters &operator+=(const BufferPoolCounters &other);
+
+  /** @return the counters, one per line */
+  std::string ToString() const;
+};
+
+/**
+ * BufferPoolStats collects the counters of a buffer pool, and optionally how often each page is accessed.
+ *
+ * Counters are kept in several cache-line sized stripes, and each thread only updates its own stripe, so counting hits
+ * on the lock-free fetch path does not make every fetch write the same cache line. Reading the counters sums the
+ * stripes, so a snapshot taken while the pool is busy is not exact.
+ *
+ * Per-page heat is off by default. When it is enabled with a sample rate of N, one access in N (per thread) is added
+ * to a histogram of page ids under a mutex.
+ */
+class BufferPoolStats {
+ public:
+  /** The counters that can be updated. */
+  enum class Counter {
+    HIT,
+    MISS,
+    EVICTION,
+    DIRTY_EVICTION,
+    PAGE_WRITE,
+    CLEANER_WRITE,
+    PREFETCH,
+    COMPRESSED_HIT,
+    SLOW_PATH_NS,
+    NUM_COUNTERS
+  };
+
+  BufferPoolStats() = default;
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolStats);
+
+  /**
+   * Adds to a counter.
+   * @param counter the counter
+   * @param value the amount to add
+   */
+  inline void Add(Counter counter, uint64_t value = 1) {
+    stripes_[GetStripe()].counters_[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+  }
+
+  /** @return the current value of every counter */
+  BufferPoolCounters GetCounters() const;
+
+  /** Sets every counter back to zero and forgets the page heat. */
+  void Reset();
+
+  /**
+   * Turns per-page heat sampling on or off.
+   * @param sample_rate record one access in this many, 0 turns sampling off
+   */
+  void SetHeatSampleRate(uint32_t sample_rate) { heat_sample_rate_.store(sample_rate, std::memory_order_relaxed); }
+
+  /**
+   * Counts an access to a page in the heat histogram, if this access is sampled.
+   * @param page_id the accessed page
+   */
+  inline void RecordAccess(page_id_t page_id) {
+    uint32_t sample_rate = heat_sample_rate_.load(std::memory_order_relaxed);
+    if (sample_rate != 0) {
+      SampleAccess(page_id, sample_rate);
+    }
+  }
+
+  /**
+   * @param max_pages the number of pages to return
+   * @return the pages with the most sampled accesses and their number of samples, hottest first
+   */
+  std::vector<std::pair<page_id_t, uint64_t>> GetHottestPages(size_t max_pages);
+
+  /**
+   * Adds the sampled accesses of this pool to a histogram, e.g. to merge the heat of several pools.
+   * @param[in,out] heat the histogram to add to
+   */
+  void MergeHeat(std::unordered_map<page_id_t, uint64_t> *heat);
+
+  /**
+   * @param heat a histogram of sampled accesses
+   * @param max_pages the number of pages to return
+   * @return the hottest pages of the histogram and their number of samples, hottest first
+   */
+  static std::vector<std::pair<page_id_t, uint64_t>> HottestPages(const std::unordered_map<page_id_t, uint64_t> &heat,
+                                                                  size_t max_pages);
+
+ private:
+  static constexpr size_t NUM_STRIPES = 16;
+
+  struct alignas(64) Stripe {
+    std::atomic<uint64_t> counters_[static_cast<size_t>(Counter::NUM_COUNTERS)]{};
+  };
+
+  /** @return the stripe of the calling thread */
+  static size_t GetStripe();
+
+  /** Slow path of RecordAccess. */
+  void SampleAccess(page_id_t page_id, uint32_t sample_rate);
+
+  Stripe stripes_[NUM_STRIPES];
+  std::atomic<uint32_t> heat_sample_rate_{0};
+  /** Protects heat_. */
+  std::mutex heat_latch_;
+  /** Number of sampled accesses per page. */
+  std::unordered_map<page_id_t, uint64_t> heat_;
+};
+
+}  // namespace bustub
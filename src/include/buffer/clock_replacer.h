@@ -43,10 +43,27 @@ class ClockReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  std::vector<frame_id_t> ColdFrames(size_t max_frames) override;
+
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
+  /** Per-frame state tracked by the clock. */
+  struct ClockFrame {
+    /** True if the frame is unpinned, i.e. it is a candidate for eviction. */
+    bool in_replacer_{false};
+    /** Reference bit, set whenever the frame is unpinned and cleared as the clock hand sweeps past. */
+    bool ref_{false};
+  };
+
+  /** Clock slots, indexed by frame id. */
+  std::vector<ClockFrame> frames_;
+  /** Position of the clock hand. */
+  size_t hand_{0};
+  /** Number of frames that are currently in the replacer. */
+  size_t size_{0};
+  /** Protects all of the above. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * CompressedPageCache is the second tier of a buffer pool: clean pages that were evicted from the pool are kept here
+ * compressed, so that fetching one again costs a decompression instead of a disk read.
+ *
+ * The cache is exclusive of the pool it backs. A page is taken out of the cache when it is read back into the pool,
+ * and must be put in again when it is next evicted, so the cache never holds a stale copy of a page the pool changed.
+ * When the cache is full, the least recently inserted pages are dropped; they are still on disk. Pages that do not
+ * compress to at most three quarters of their size are not worth keeping and are not cached.
+ *
+ * The cache is not thread-safe; the buffer pool only uses it under its latch.
+ */
+class CompressedPageCache {
+ public:
+  /**
+   * Creates an empty cache.
+   * @param capacity the total size of the compressed pages the cache may hold, in bytes
+   * @param page_size the size of the pages before compression
+   */
+  explicit CompressedPageCache(size_t capacity, size_t page_size = PAGE_SIZE)
+      : capacity_(capacity),
+        page_size_(page_size),
+        max_compressed_size_(page_size / 4 * 3),
+        buffer_(new char[max_compressed_size_]) {}
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  /**
+   * Compresses a clean page into the cache, replacing any copy that is already there.
+   * @param page_id the id of the page
+   * @param data the page data, page_size bytes
+   * @return false if the page did not compress well enough to be kept
+   */
+  bool Put(page_id_t page_id, const char *data);
+
+  /**
+   * Takes a page out of the cache.
+   * @param page_id the id of the page
+   * @param[out] data where to decompress the page, page_size bytes
+   * @return false if the page is not in the cache
+   */
+  bool Take(page_id_t page_id, char *data);
+
+  /** Drops a page from the cache, e.g. because it was deleted. */
+  void Invalidate(page_id_t page_id);
+
+  /** @return the number of pages in the cache */
+  size_t Size() const { return entries_.size(); }
+
+  /** @return the total size of the compressed pages in the cache, in bytes */
+  size_t GetUsedBytes() const { return used_bytes_; }
+
+ private:
+  struct Entry {
+    page_id_t page_id_;
+    size_t size_;
+    std::unique_ptr<char[]> data_;
+  };
+
+  /** Drops the oldest pages until there is room for size more bytes. */
+  void MakeRoom(size_t size);
+
+  size_t capacity_;
+  size_t page_size_;
+  /** Largest compressed page worth keeping. */
+  size_t max_compressed_size_;
+  /** Where pages are compressed before it is known whether they are worth keeping. */
+  std::unique_ptr<char[]> buffer_;
+  size_t used_bytes_{0};
+  /** Cached pages, oldest first. */
+  std::list<Entry> entries_;
+  std::unordered_map<page_id_t, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace bustub
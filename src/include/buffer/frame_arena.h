@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameArena is the memory that holds the page data of a buffer pool, one frame after the other. Frames are the size of
+ * the pages of the file the pool caches, PAGE_SIZE unless the file uses another page size.
+ *
+ * The arena is a single anonymous mapping, so it starts on a system page boundary and frames of at least
+ * DIRECT_IO_ALIGNMENT bytes are aligned as O_DIRECT asks of the buffers it reads into and writes from. It is backed by
+ * 2 MB huge pages when the system has some reserved, and otherwise asks for transparent huge pages, so that a large
+ * pool needs far fewer TLB entries than one made of individually allocated frames. The arena can also be bound to a
+ * NUMA node, so that each instance of a partitioned pool keeps its frames local to the threads that use them. Both are
+ * best effort: the arena silently falls back to ordinary pages on systems that do not support them.
+ *
+ * Frame data is zeroed when the arena is created. An arena can be made larger than the pool that uses it, so that the
+ * pool can grow into it later: frames that are never touched never take up physical memory.
+ */
+class FrameArena {
+ public:
+  /** Do not bind the arena to any NUMA node. */
+  static constexpr int NO_NUMA_NODE = -1;
+
+  /**
+   * Maps a new arena.
+   * @param num_frames the number of frames
+   * @param numa_node the NUMA node to allocate the frames on, or NO_NUMA_NODE
+   * @param frame_size the size of each frame, a power of two no larger than MAX_PAGE_SIZE
+   */
+  explicit FrameArena(size_t num_frames, int numa_node = NO_NUMA_NODE, size_t frame_size = PAGE_SIZE);
+
+  /** Unmaps the arena. */
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the data of the given frame */
+  inline char *GetFrame(frame_id_t frame_id) { return data_ + static_cast<size_t>(frame_id) * frame_size_; }
+
+  /** @return the size of each frame, in bytes */
+  size_t GetFrameSize() const { return frame_size_; }
+
+  /**
+   * Zeroes a range of frames and gives their memory back to the system where possible, e.g. when a pool shrinks.
+   * The frames stay mapped and can be used again later.
+   * @param first_frame the first frame to discard
+   * @param num_frames the number of frames to discard
+   */
+  void Discard(frame_id_t first_frame, size_t num_frames);
+
+  /** @return true if the arena is backed by reserved huge pages */
+  bool IsHugePageBacked() const { return huge_pages_; }
+
+  /** @return the number of NUMA nodes of this machine, 1 if it has no NUMA support */
+  static int GetNumNumaNodes();
+
+ private:
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  char *data_;
+  size_t frame_size_;
+  /** The length of the mapping, rounded up to the page size that backs it. */
+  size_t size_;
+  bool huge_pages_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lock_free_page_table.h
+//
+// Identification: src/include/buffer/lock_free_page_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * LockFreePageTable maps resident page ids to frame ids for a single buffer pool instance.
+ *
+ * It is a fixed-capacity open-addressing (linear probing) hash table whose slots are single 64-bit atomics holding
+ * both the page id and the frame id, so Find() never blocks and never writes to shared memory. Insert() and Remove()
+ * must be serialized by the caller (the buffer pool latch); they may run concurrently with any number of Find()s.
+ *
+ * Removal leaves a tombstone, which is turned back into an empty slot as soon as the slot after it is empty. This
+ * keeps the invariant that no key's probe sequence ever crosses an empty slot, which is what makes a concurrent
+ * Find() that stops at an empty slot correct.
+ */
+class LockFreePageTable {
+ public:
+  /**
+   * Creates a new page table.
+   * @param num_frames the maximum number of entries the table will ever hold at the same time
+   */
+  explicit LockFreePageTable(size_t num_frames);
+
+  ~LockFreePageTable() = default;
+
+  DISALLOW_COPY_AND_MOVE(LockFreePageTable);
+
+  /**
+   * Looks up a page. Safe to call without any latch.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame holding the page, if found
+   * @return true if the page was found
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const {
+    const uint64_t mask = capacity_ - 1;
+    for (uint64_t i = Hash(page_id), probes = 0; probes < capacity_; i = (i + 1) & mask, probes++) {
+      uint64_t slot = slots_[i].load(std::memory_order_acquire);
+      if (slot == EMPTY) {
+        return false;
+      }
+      if (slot != TOMBSTONE && KeyOf(slot) == page_id) {
+        *frame_id = FrameOf(slot);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Inserts a page that is not in the table yet. Caller must hold the buffer pool latch.
+   * @param page_id the page to insert
+   * @param frame_id the frame holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Removes a page. Caller must hold the buffer pool latch.
+   * @param page_id the page to remove
+   * @return true if the page was in the table
+   */
+  bool Remove(page_id_t page_id);
+
+  /** @return the number of pages in the table */
+  size_t Size() const { return size_; }
+
+ private:
+  static constexpr uint64_t EMPTY = ~static_cast<uint64_t>(0);
+  static constexpr uint64_t TOMBSTONE = EMPTY - 1;
+
+  static uint64_t Pack(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static page_id_t KeyOf(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+  static frame_id_t FrameOf(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** Fibonacci hashing: page ids are mostly dense, so spread them over the whole table. */
+  uint64_t Hash(page_id_t page_id) const {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 11400714819323198485ULL) >> shift_;
+  }
+
+  /** Number of slots, always a power of two and at least twice the number of frames. */
+  uint64_t capacity_;
+  /** 64 - log2(capacity_), used by Hash(). */
+  uint32_t shift_;
+  /** Number of live entries. Only touched by writers. */
+  size_t size_{0};
+  /** The slots themselves. */
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The victim is the frame whose K-th most recent access is furthest in the past (its backward K-distance is the
+ * largest). Frames with fewer than K recorded accesses have an infinite backward K-distance and are evicted first,
+ * oldest access first, so pages touched once by a scan go before pages that are reused.
+ *
+ * An access is recorded whenever a frame is pinned. The buffer pool only calls Pin when a page goes from unpinned to
+ * pinned, so concurrent pins of the same page count once, as correlated references should. So do accesses that come
+ * within the correlated reference period of the one before, e.g. a scan coming back to its page for every tuple: a page
+ * touched only by a scan keeps a single access, however many tuples it holds.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of most recent accesses that are remembered for each frame
+   * @param correlated_period the number of accesses, to any frame, within which an access to the same frame again is
+   * part of the same reference; 0 to count every access
+   */
+  LRUKReplacer(size_t num_pages, size_t k, size_t correlated_period = CORRELATED_REFERENCE_PERIOD);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  std::vector<frame_id_t> ColdFrames(size_t max_frames) override;
+
+  size_t Size() override;
+
+ private:
+  /** Per-frame access history. */
+  struct FrameHistory {
+    /** Timestamps of the (at most k) most recent accesses, oldest first. */
+    std::deque<size_t> accesses_;
+    /** Timestamp of the most recent access, correlated or not. */
+    size_t last_access_{0};
+    /** True if the frame is unpinned and sits in one of the eviction sets. */
+    bool evictable_{false};
+    /** The key the frame is filed under in its eviction set. */
+    size_t key_{0};
+  };
+
+  /** Removes a frame from whichever eviction set it is in. */
+  void MakeUnevictable(frame_id_t frame_id);
+
+  /** Lookback window. */
+  size_t k_;
+  /** Accesses within this many ticks of the frame's last one are not recorded. */
+  size_t correlated_period_;
+  /** Logical clock, incremented on every access. */
+  size_t current_timestamp_{0};
+  /** Access history, indexed by frame id. */
+  std::vector<FrameHistory> frames_;
+  /** Evictable frames with fewer than k accesses, keyed by their oldest access. */
+  std::set<std::pair<size_t, frame_id_t>> cold_;
+  /** Evictable frames with k accesses, keyed by their k-th most recent access. */
+  std::set<std::pair<size_t, frame_id_t>> hot_;
+  /** Protects all of the above. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
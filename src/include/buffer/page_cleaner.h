@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_cleaner.h
+//
+// Identification: src/include/buffer/page_cleaner.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageCleaner runs a buffer pool's cleaning pass on a background thread, every page_cleaner_interval or as soon as it
+ * is woken up, e.g. because a foreground eviction had to write back a dirty victim itself.
+ *
+ * What a pass does is up to the buffer pool; the cleaner only owns the thread.
+ */
+class PageCleaner {
+ public:
+  /** Writes back some dirty pages and returns how many it wrote. */
+  using clean_fn = std::function<size_t()>;
+
+  /**
+   * Creates a stopped page cleaner.
+   * @param clean one cleaning pass over the buffer pool
+   */
+  explicit PageCleaner(clean_fn clean);
+
+  /** Stops the background thread if it is running. */
+  ~PageCleaner();
+
+  DISALLOW_COPY_AND_MOVE(PageCleaner);
+
+  /** Starts the background thread. Does nothing if it is already running. */
+  void Run();
+
+  /** Stops and joins the background thread. Must be called before the pages it cleans are destroyed. */
+  void Stop();
+
+  /** Asks for a cleaning pass right away instead of at the end of the interval. Cheap if the cleaner is stopped. */
+  void Wake();
+
+  /** @return true if the background thread is running */
+  bool IsRunning();
+
+ private:
+  /** Body of the background thread. */
+  void Loop();
+
+  clean_fn clean_;
+  bool running_{false};
+  bool woken_{false};
+  std::thread thread_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+}  // namespace bustub
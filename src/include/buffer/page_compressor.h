@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.h
+//
+// Identification: src/include/buffer/page_compressor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * PageCompressor is a small LZ77 codec in the spirit of the LZ4 block format, tuned for speed rather than ratio.
+ *
+ * The compressed stream is a series of sequences. Each one starts with a token byte whose high nibble is a literal
+ * length and whose low nibble is a match length minus 4; a nibble of 15 is continued by bytes of 255 and one final
+ * byte. The literals follow, then a 2-byte little-endian offset back into the output and the rest of the match length.
+ * The last sequence has literals only.
+ */
+class PageCompressor {
+ public:
+  /**
+   * Compresses a buffer.
+   * @param src the data to compress, at most 64 KB
+   * @param src_size the size of the data
+   * @param[out] dst where to write the compressed data
+   * @param dst_capacity the size of dst
+   * @return the size of the compressed data, or 0 if it does not fit in dst_capacity
+   */
+  static size_t Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity);
+
+  /**
+   * Decompresses what Compress produced.
+   * @param src the compressed data
+   * @param src_size the size of the compressed data
+   * @param[out] dst where to write the data
+   * @param dst_size the exact size of the data
+   * @return false if the compressed data is malformed or does not decompress to exactly dst_size bytes
+   */
+  static bool Decompress(const char *src, size_t src_size, char *dst, size_t dst_size);
+};
+
+}  // namespace bustub
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/prefetcher.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager splits its frames into several independent BufferPoolManagerInstances, each with its own
+ * page table, free list, replacer and latch. A page always lives in the instance given by page_id % num_instances, so
+ * operations on pages owned by different instances never contend with each other.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used by every instance
+   * @param replacer_k the lookback window of the LRU-K replacer, ignored by the other policies
+   * @param numa_aware if true, the frames of the instances are spread round-robin over the machine's NUMA nodes
+   * @param max_pool_size the size Resize may grow each instance to, 0 if it should never grow beyond pool_size
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::CLOCK,
+                            size_t replacer_k = LRUK_REPLACER_K, bool numa_aware = false, size_t max_pool_size = 0);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return size of the buffer pool, i.e. the total number of frames across all instances */
+  size_t GetPoolSize() override;
+
+  size_t GetPageSize() override { return disk_manager_->GetPageSize(); }
+
+  /**
+   * Resizes every instance, spreading the frames as evenly as possible. If an instance cannot be resized, the ones
+   * that already were are put back to their old size. Putting back an instance that grew can itself fail if pages got
+   * pinned in its new frames meanwhile; it then keeps its new size, which is logged.
+   * @param pool_size the new total number of frames, at least one per instance
+   * @return false if the pool was not resized as asked
+   */
+  bool Resize(size_t pool_size) override;
+
+  /**
+   * Gives every instance an equal share of the compressed tier.
+   * @param capacity the memory the compressed pages of all the instances may take up, in bytes, 0 turns the tier off
+   */
+  void SetCompressedTierCapacity(size_t capacity) override;
+
+  /** @return the counters of all the instances added up */
+  BufferPoolCounters GetStats() override;
+
+  void ResetStats() override;
+
+  void SetHeatSampleRate(uint32_t sample_rate) override;
+
+  /** @return the hottest pages across all the instances */
+  std::vector<std::pair<page_id_t, uint64_t>> GetHottestPages(size_t max_pages) override;
+
+  /** @return the number of instances */
+  size_t GetNumInstances() const { return instances_.size(); }
+
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling the given page id
+   */
+  BufferPoolManagerInstance *GetBufferPoolManager(page_id_t page_id);
+
+  /** Starts the background page cleaner of every instance. */
+  void RunPageCleaner();
+
+  /** Stops the background page cleaner of every instance. */
+  void StopPageCleaner();
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id) override;
+
+  Page *FetchPageWithStrategyImpl(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  bool ReleasePageImpl(page_id_t page_id) override;
+
+  /** Read-ahead chains cross instances, so they are followed by a prefetcher of our own rather than the instances'. */
+  void PrefetchPageImpl(page_id_t page_id, size_t depth, const next_page_fn &next_page) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  /**
+   * Allocates a page id on disk and creates the page in the instance that owns it. If that instance has every frame
+   * pinned, the id is given back and the next one is tried, so that a single full instance does not fail the call
+   * while the others still have room.
+   */
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  Page *NewPageInExtentImpl(page_id_t *page_id, PageExtent *extent) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  /** Flushes the pages of all the instances as a single batch, so that pages adjacent on disk are written together. */
+  void FlushAllPagesImpl() override;
+
+ private:
+  /** The individual buffer pool shards. */
+  std::vector<BufferPoolManagerInstance *> instances_;
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** Background reader for PrefetchPage. Its thread only starts with the first request. */
+  Prefetcher prefetcher_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefetcher.h
+//
+// Identification: src/include/buffer/prefetcher.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Prefetcher reads pages into a buffer pool on a background thread, so that a scan can overlap its I/O with the
+ * processing of the pages it already has.
+ *
+ * A request names the first page to read and how many pages to follow after it. The prefetcher does not know how pages
+ * are linked: loading a page is delegated to the read-ahead function of its buffer pool, which returns the id of the
+ * following page as reported by the request's next_page_fn.
+ *
+ * The thread is only started by the first request, so buffer pools that never read ahead do not pay for it. Requests
+ * beyond PREFETCH_QUEUE_SIZE are dropped: read-ahead is a hint and must never hold up the caller.
+ */
+class Prefetcher {
+ public:
+  /** Loads a page without pinning it and returns the id of the next page to read ahead, or INVALID_PAGE_ID. */
+  using read_ahead_fn = std::function<page_id_t(page_id_t page_id, const BufferPoolManager::next_page_fn &next_page)>;
+
+  /**
+   * Creates a new prefetcher.
+   * @param read_ahead the function that loads a single page into the buffer pool
+   */
+  explicit Prefetcher(read_ahead_fn read_ahead);
+
+  /** Stops the background thread, dropping the requests it has not started yet. */
+  ~Prefetcher();
+
+  DISALLOW_COPY_AND_MOVE(Prefetcher);
+
+  /**
+   * Queues a read-ahead request and returns right away.
+   * @param page_id the first page to read
+   * @param depth the number of pages to read, following the chain of next pages
+   * @param next_page returns the page following a loaded page; may be empty if depth is 1
+   */
+  void Enqueue(page_id_t page_id, size_t depth, BufferPoolManager::next_page_fn next_page);
+
+  /** Blocks until every queued request has been served. */
+  void WaitUntilIdle();
+
+  /** Stops and joins the background thread. Must be called before the frames it loads into are destroyed. */
+  void Stop();
+
+ private:
+  struct Request {
+    page_id_t page_id_;
+    size_t depth_;
+    BufferPoolManager::next_page_fn next_page_;
+  };
+
+  /** Body of the background thread. */
+  void Run();
+
+  read_ahead_fn read_ahead_;
+  std::deque<Request> queue_;
+  /** True while the background thread is serving a request. */
+  bool busy_{false};
+  bool stopped_{false};
+  std::thread thread_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  /** Signalled when the queue drains. */
+  std::condition_variable idle_cv_;
+};
+
+}  // namespace bustub
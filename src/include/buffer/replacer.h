@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be built with. */
+enum class ReplacerType { CLOCK, LRU_K, TWO_QUEUE };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -25,7 +30,18 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
+   * Creates a replacer for the given policy.
+   * @param replacer_type the replacement policy
+   * @param num_pages the maximum number of pages the replacer will be required to store
+   * @param k the lookback window, only used by LRU-K
+   * @return the new replacer, owned by the caller
+   */
+  static Replacer *Create(ReplacerType replacer_type, size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+  /**
+   * Remove the victim frame as defined by the replacement policy. Policies that keep access history keep the victim's
+   * until Remove is called, so the caller must call Remove once it has claimed the frame for a new page; if it cannot,
+   * e.g. because the page was pinned again meanwhile, the page keeps its history.
    * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
    * @return true if a victim frame was found, false otherwise
    */
@@ -43,6 +59,21 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forgets a frame entirely, e.g. because its page was deleted. Policies that keep access history must drop it here so
+   * that the next page to use the frame starts from scratch; for the others this is the same as Pin.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Lists the frames that are next in line for eviction without evicting them, e.g. so that they can be written back
+   * before anybody needs them.
+   * @param max_frames the maximum number of frames to list
+   * @return up to max_frames evictable frames, likeliest victim first
+   */
+  virtual std::vector<frame_id_t> ColdFrames(size_t max_frames) = 0;
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
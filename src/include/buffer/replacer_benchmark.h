@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark.h
+//
+// Identification: src/include/buffer/replacer_benchmark.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "buffer/access_trace.h"
+#include "buffer/replacer.h"
+
+namespace bustub {
+
+/** What replaying a trace against one replacement policy measured. */
+struct ReplayResult {
+  /** Number of accesses replayed. */
+  uint64_t accesses_{0};
+  /** Accesses whose page was resident. */
+  uint64_t hits_{0};
+  /** Accesses per second, counting only the time spent in the replacer and the simulated page table. */
+  double throughput_{0};
+  /** Latency percentiles of a single access, in nanoseconds. */
+  uint64_t p50_ns_{0};
+  uint64_t p99_ns_{0};
+  uint64_t p999_ns_{0};
+  uint64_t max_ns_{0};
+
+  /** @return the fraction of accesses that were hits */
+  double HitRatio() const { return accesses_ == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(accesses_); }
+
+  /** @return the result on one line, prefixed with the name of the policy */
+  std::string ToString(const std::string &policy) const;
+};
+
+/**
+ * ReplacerBenchmark replays an AccessTrace against a Replacer, simulating a buffer pool of a given number of frames:
+ * each access pins its page, reading it into a free frame or the replacer's victim on a miss, and unpins it right away.
+ * No page data is moved, so the measured latency is that of the replacement policy itself.
+ */
+class ReplacerBenchmark {
+ public:
+  /**
+   * Replays a trace.
+   * @param trace the accesses to replay
+   * @param replacer the policy to replay them against, sized for at least num_frames frames and initially empty
+   * @param num_frames the number of frames of the simulated buffer pool, at least 1
+   * @return the hit ratio, throughput and latency of the replay; an empty result, with no accesses, if num_frames is 0
+   */
+  static ReplayResult Replay(const AccessTrace &trace, Replacer *replacer, size_t num_frames);
+
+  /** @return a printable name for a replacement policy */
+  static std::string PolicyName(ReplacerType replacer_type);
+};
+
+}  // namespace bustub
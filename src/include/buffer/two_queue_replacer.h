@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the simplified 2Q replacement policy (Johnson and Shasha, VLDB '94).
+ *
+ * A frame enters the A1 queue on the first access to its page and is promoted to the Am queue when it is accessed
+ * again. A1 is managed as a FIFO and Am as an LRU. Victims are taken from A1 while it holds more than its share of
+ * the frames, so a page that is only touched once, e.g. by a sequential scan, never pushes reused pages out of Am.
+ *
+ * As with LRUKReplacer, an access is recorded each time a frame goes from unpinned to pinned, and accesses within the
+ * correlated reference period of the one before do not count as a second access.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer. A1 is allowed to hold a quarter of the frames before it is drained first.
+   * @param num_pages the maximum number of pages the TwoQueueReplacer will be required to store
+   * @param correlated_period the number of accesses, to any frame, within which an access to the same frame again does
+   * not promote it to Am; 0 to promote on any second access
+   */
+  explicit TwoQueueReplacer(size_t num_pages, size_t correlated_period = CORRELATED_REFERENCE_PERIOD);
+
+  /**
+   * Destroys the TwoQueueReplacer.
+   */
+  ~TwoQueueReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  std::vector<frame_id_t> ColdFrames(size_t max_frames) override;
+
+  size_t Size() override;
+
+ private:
+  /** Per-frame queue membership. */
+  struct QueueFrame {
+    /** True once the page in the frame has been seen by the replacer. */
+    bool tracked_{false};
+    /** True if the frame has been promoted to Am. */
+    bool in_am_{false};
+    /** True if the frame is unpinned and sits in one of the eviction sets. */
+    bool evictable_{false};
+    /** True from Victim until the caller's Remove, or until the page is pinned again because the eviction failed. */
+    bool victim_{false};
+    /** Time of the first access, which orders A1. */
+    size_t first_access_{0};
+    /** Time of the most recent access, which orders Am. */
+    size_t last_access_{0};
+  };
+
+  /** Starts tracking a frame in A1. */
+  void Track(frame_id_t frame_id);
+
+  /** Stops tracking a frame, removing it from whichever queue it is in. */
+  void Untrack(frame_id_t frame_id);
+
+  /** Removes a frame from whichever eviction set it is in. */
+  void MakeUnevictable(frame_id_t frame_id);
+
+  /** Takes a frame back from Victim, with its history, because its page stayed after all. */
+  void KeepVictim(frame_id_t frame_id);
+
+  /** Once A1 holds more than this many frames, victims are taken from A1 first. */
+  size_t a1_threshold_;
+  /** Accesses within this many ticks of the frame's last one do not promote it. */
+  size_t correlated_period_;
+  /** Number of frames in A1, pinned or not. */
+  size_t a1_size_{0};
+  /** Logical clock, incremented on every access. */
+  size_t current_timestamp_{0};
+  /** Queue membership, indexed by frame id. */
+  std::vector<QueueFrame> frames_;
+  /** Evictable frames in A1, keyed by first access. */
+  std::set<std::pair<size_t, frame_id_t>> a1_;
+  /** Evictable frames in Am, keyed by most recent access. */
+  std::set<std::pair<size_t, frame_id_t>> am_;
+  /** Protects all of the above. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bustub_config.h
+//
+// Identification: src/include/common/bustub_config.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * BustubConfig holds the settings a BustubInstance is created with that are worth choosing per host rather than at
+ * compile time. The defaults are the compile-time constants from common/config.h.
+ */
+struct BustubConfig {
+  /** Size of the pages of the db file, and of the frames of the buffer pool, in bytes. */
+  size_t page_size_{PAGE_SIZE};
+  /** Number of frames in the buffer pool. */
+  size_t buffer_pool_size_{BUFFER_POOL_SIZE};
+  /** Number of frames the buffer pool can be resized to online, 0 for no more than buffer_pool_size_. */
+  size_t max_buffer_pool_size_{0};
+  /** Memory for compressed copies of evicted pages, in bytes, 0 for none. */
+  size_t compressed_tier_size_{0};
+  /** Size of the log buffer in bytes. */
+  size_t log_buffer_size_{LOG_BUFFER_SIZE};
+  /** Replacement policy of the buffer pool. */
+  ReplacerType replacer_type_{ReplacerType::CLOCK};
+  /** Lookback window of the LRU-K replacer. */
+  size_t replacer_k_{LRUK_REPLACER_K};
+  /** More db files to stripe the database over, e.g. on other devices, after the one the instance is created with. */
+  std::vector<std::string> stripe_files_;
+  /** Read and write the db file with O_DIRECT, bypassing the operating system's page cache. */
+  bool direct_io_{false};
+  /** Read pages out of a mapping of the db file, which pays off for read-mostly databases. Ignored with direct I/O. */
+  bool mmap_reads_{false};
+
+  /**
+   * Reads a config from the environment. Every setting that is not set, or cannot be parsed, keeps its default:
+   *  - BUSTUB_PAGE_SIZE: bytes, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE
+   *  - BUSTUB_BUFFER_POOL_SIZE, BUSTUB_MAX_BUFFER_POOL_SIZE: numbers of frames
+   *  - BUSTUB_COMPRESSED_TIER_SIZE, BUSTUB_LOG_BUFFER_SIZE: bytes
+   *  - BUSTUB_REPLACER: one of "clock", "lru-k" or "2q"
+   *  - BUSTUB_REPLACER_K: the lookback window of LRU-K
+   *  - BUSTUB_STRIPE_FILES: comma-separated paths of more db files to stripe the database over
+   *  - BUSTUB_DIRECT_IO: 1 to use O_DIRECT, 0 not to
+   *  - BUSTUB_MMAP_READS: 1 to read pages from a mapping of the db file, 0 not to
+   * @return the config
+   */
+  static BustubConfig FromEnvironment();
+};
+
+}  // namespace bustub
@@ -10,10 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sstream>
 #include <string>
+#include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/bustub_config.h"
 #include "common/config.h"
+#include "common/logger.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
@@ -23,16 +27,30 @@ namespace bustub {
 
 class BustubInstance {
  public:
-  explicit BustubInstance(const std::string &db_file_name) {
+  /**
+   * Creates an instance on top of a database file.
+   * @param db_file_name the database file
+   * @param config the page size, the sizes of the buffer pool and log buffer, the replacement policy and how to do
+   * I/O, e.g. from BustubConfig::FromEnvironment()
+   */
+  explicit BustubInstance(const std::string &db_file_name, const BustubConfig &config = BustubConfig()) {
     enable_logging = false;
 
     // storage related
-    disk_manager_ = new DiskManager(db_file_name);
+    std::vector<std::string> db_files{db_file_name};
+    db_files.insert(db_files.end(), config.stripe_files_.begin(), config.stripe_files_.end());
+    disk_manager_ = new DiskManager(db_files, config.direct_io_, config.page_size_);
+    if (config.mmap_reads_ && !disk_manager_->EnableMappedReads()) {
+      LOG_WARN("cannot map %s, reading it with pread", db_file_name.c_str());
+    }
 
     // log related
-    log_manager_ = new LogManager(disk_manager_);
+    log_manager_ = new LogManager(disk_manager_, config.log_buffer_size_);
 
-    buffer_pool_manager_ = new BufferPoolManager(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
+    buffer_pool_manager_ =
+        new BufferPoolManagerInstance(config.buffer_pool_size_, disk_manager_, log_manager_, config.replacer_type_,
+                                      config.replacer_k_, FrameArena::NO_NUMA_NODE, config.max_buffer_pool_size_);
+    buffer_pool_manager_->SetCompressedTierCapacity(config.compressed_tier_size_);
 
     // txn related
     lock_manager_ = new LockManager(TwoPLMode::STRICT, DeadlockMode::PREVENTION);  // S2PL
@@ -54,8 +72,25 @@ class BustubInstance {
     delete disk_manager_;
   }
 
+  /**
+   * @param num_hot_pages the number of hottest pages to list, if heat sampling is on
+   * @return the buffer pool counters and its hottest pages, one per line
+   */
+  std::string DumpBufferPoolStats(size_t num_hot_pages = 10) {
+    std::ostringstream os;
+    os << buffer_pool_manager_->GetStats().ToString();
+    auto hot_pages = buffer_pool_manager_->GetHottestPages(num_hot_pages);
+    if (!hot_pages.empty()) {
+      os << "hottest pages:\n";
+      for (const auto &[page_id, samples] : hot_pages) {
+        os << "  page " << page_id << ": " << samples << "\n";
+      }
+    }
+    return os.str();
+  }
+
   DiskManager *disk_manager_;
-  BufferPoolManager *buffer_pool_manager_;
+  BufferPoolManagerInstance *buffer_pool_manager_;
   LockManager *lock_manager_;
   TransactionManager *transaction_manager_;
   LogManager *log_manager_;
@@ -27,14 +27,31 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** A running page cleaner writes back the dirty pages at the cold end of its buffer pool this often. */
+extern std::chrono::milliseconds page_cleaner_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
-static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int PAGE_SIZE = 4096;                                        // default size of a data page in byte
+static constexpr int MIN_PAGE_SIZE = PAGE_SIZE;                               // smallest page size a file may use
+static constexpr int MAX_PAGE_SIZE = 64 * 1024;                               // largest page size a file may use
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LRUK_REPLACER_K = 2;                                     // lookback window for lru-k replacer
+static constexpr int CORRELATED_REFERENCE_PERIOD = 4;                         // accesses that still count as one
+static constexpr int SCAN_RING_SIZE = 16;                                     // frames a scan may recycle privately
+static constexpr int READ_AHEAD_PAGES = 4;                                    // pages a scan reads ahead of itself
+static constexpr int PREFETCH_QUEUE_SIZE = 64;                                // pending read-ahead requests
+static constexpr int PAGE_CLEANER_BATCH = 16;                                 // cold frames a page cleaner checks
+static constexpr int OPTIMISTIC_READ_RETRIES = 3;                             // optimistic reads before latching
+static constexpr int ASYNC_IO_QUEUE_DEPTH = 64;                               // asynchronous I/Os in flight
+static constexpr int ASYNC_IO_THREADS = 8;                                    // threads of the pread/pwrite fallback
+static constexpr int DIRECT_IO_ALIGNMENT = 4096;                              // buffer alignment O_DIRECT requires
+static constexpr int EXTENT_SIZE = 64;                                        // contiguous pages a table heap reserves
+static constexpr int STRIPE_SIZE = EXTENT_SIZE;                               // contiguous pages per striped db file
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -28,10 +28,15 @@ namespace bustub {
  */
 class LogManager {
  public:
-  explicit LogManager(DiskManager *disk_manager)
-      : next_lsn_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
-    flush_buffer_ = new char[LOG_BUFFER_SIZE];
+  /**
+   * Creates a new LogManager.
+   * @param disk_manager the disk manager the log is written through
+   * @param log_buffer_size the size of the log buffer and of the flush buffer, in bytes
+   */
+  explicit LogManager(DiskManager *disk_manager, size_t log_buffer_size = LOG_BUFFER_SIZE)
+      : next_lsn_(0), persistent_lsn_(INVALID_LSN), log_buffer_size_(log_buffer_size), disk_manager_(disk_manager) {
+    log_buffer_ = new char[log_buffer_size_];
+    flush_buffer_ = new char[log_buffer_size_];
   }
 
   ~LogManager() {
@@ -50,6 +55,7 @@ class LogManager {
   inline lsn_t GetPersistentLSN() { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
   inline char *GetLogBuffer() { return log_buffer_; }
+  inline size_t GetLogBufferSize() const { return log_buffer_size_; }
 
  private:
   // TODO(students): you may add your own member variables
@@ -59,6 +65,8 @@ class LogManager {
   /** The log records before and including the persistent lsn have been written to disk. */
   std::atomic<lsn_t> persistent_lsn_;
 
+  /** The size of log_buffer_ and flush_buffer_. */
+  size_t log_buffer_size_;
   char *log_buffer_;
   char *flush_buffer_;
 
@@ -19,6 +19,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/log_record.h"
+#include "storage/disk/disk_manager.h"
 
 namespace bustub {
 
@@ -27,9 +28,20 @@ namespace bustub {
  */
 class LogRecovery {
  public:
-  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
-      : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), offset_(0) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
+  /**
+   * Creates a new LogRecovery.
+   * @param disk_manager the disk manager the log is read through
+   * @param buffer_pool_manager the buffer pool the pages are redone and undone in
+   * @param log_buffer_size the size of the buffer the log is read into, in bytes; at least the log buffer size of the
+   * LogManager that wrote the log, so that every record it flushed fits
+   */
+  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager,
+              size_t log_buffer_size = LOG_BUFFER_SIZE)
+      : disk_manager_(disk_manager),
+        buffer_pool_manager_(buffer_pool_manager),
+        offset_(0),
+        log_buffer_size_(log_buffer_size) {
+    log_buffer_ = new char[log_buffer_size_];
   }
 
   ~LogRecovery() {
@@ -51,6 +63,8 @@ class LogRecovery {
   std::unordered_map<lsn_t, int> lsn_mapping_;
 
   int offset_ __attribute__((__unused__));
+  /** The size of log_buffer_, which is also how much of the log ReadLog reads at a time. */
+  size_t log_buffer_size_;
   char *log_buffer_;
 };
 
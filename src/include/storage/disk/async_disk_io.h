@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_io.h
+//
+// Identification: src/include/storage/disk/async_disk_io.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** One asynchronous read or write of consecutive pages. */
+struct DiskRequest {
+  /** True to write the pages, false to read them. */
+  bool is_write_;
+  /** The first page. */
+  page_id_t page_id_;
+  /** The data of the pages, which must stay valid until the request completes. */
+  char *data_;
+  /** The number of consecutive pages. */
+  size_t num_pages_{1};
+  /**
+   * Called once the request has completed, with false if it failed, on a thread of the backend. Reads past the end of
+   * the file succeed, and fill the missing part of the data with zeros, like DiskManager::ReadPage.
+   */
+  std::function<void(bool)> callback_;
+  /** The size of each page, i.e. the page size of the file. */
+  size_t page_size_{PAGE_SIZE};
+};
+
+/**
+ * AsyncDiskIO reads and writes pages of a file without waiting for them, so that many I/Os can be in flight at once.
+ *
+ * Requests are submitted with Submit and complete in any order, each by calling its callback. There are two backends:
+ * one on io_uring, which needs no thread per request in flight, and a pool of threads doing pread/pwrite for kernels
+ * without io_uring. Create picks io_uring when the kernel lets us set up a ring.
+ *
+ * At most queue_depth requests are in flight; Submit waits for one to complete when that many are. Requests must
+ * therefore never be submitted from a callback.
+ */
+class AsyncDiskIO {
+ public:
+  /**
+   * Creates the best backend available.
+   * @param fd the file to read and write, which must stay open as long as the backend
+   * @param queue_depth the maximum number of requests in flight
+   * @return the io_uring backend if the kernel supports it, otherwise the thread pool backend
+   */
+  static std::unique_ptr<AsyncDiskIO> Create(int fd, size_t queue_depth = ASYNC_IO_QUEUE_DEPTH);
+
+  /** @return an io_uring backend, or nullptr if io_uring is not available */
+  static std::unique_ptr<AsyncDiskIO> CreateIoUring(int fd, size_t queue_depth = ASYNC_IO_QUEUE_DEPTH);
+
+  /** @return a pread/pwrite thread pool backend with at most ASYNC_IO_THREADS threads */
+  static std::unique_ptr<AsyncDiskIO> CreateThreadPool(int fd, size_t queue_depth = ASYNC_IO_QUEUE_DEPTH);
+
+  /** Waits for the requests in flight; the destructors of the backends then stop their threads. */
+  virtual ~AsyncDiskIO() = default;
+
+  DISALLOW_COPY_AND_MOVE(AsyncDiskIO);
+
+  /**
+   * Starts a request, waiting first if queue_depth requests are already in flight. A request the backend cannot take
+   * is completed at once, with false, on the calling thread.
+   * @param request the request
+   */
+  virtual void Submit(DiskRequest request) = 0;
+
+  /** Waits until every request submitted so far has completed. */
+  void Drain();
+
+  /** @return the name of the backend, "io_uring" or "thread_pool" */
+  virtual const char *GetName() const = 0;
+
+ protected:
+  AsyncDiskIO(int fd, size_t queue_depth) : fd_(fd), queue_depth_(queue_depth) {}
+
+  /** Waits for a free slot and takes it. Called by Submit before anything else. */
+  void BeginRequest();
+
+  /** Runs the callback of a completed request and frees its slot. */
+  void CompleteRequest(const DiskRequest &request, bool success);
+
+  /**
+   * Reads or writes a request synchronously with pread/pwrite, e.g. to finish a short io_uring transfer.
+   * @param request the request
+   * @param done the number of bytes already transferred
+   * @return false on an I/O error
+   */
+  bool Transfer(const DiskRequest &request, size_t done);
+
+  int fd_;
+  size_t queue_depth_;
+
+ private:
+  std::mutex latch_;
+  std::condition_variable cv_;
+  size_t in_flight_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_io_stats.h
+//
+// Identification: src/include/storage/disk/disk_io_stats.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/** The kinds of I/O a DiskManager does. */
+enum class IOOperation {
+  /** Page reads from the file, and reads of the log during recovery. */
+  READ,
+  /** Page reads copied out of the mapping of the file. Mostly page cache hits, so they are kept apart from READ. */
+  MAPPED_READ,
+  /** Page writes; a batch written with WritePages counts once per gathering write. */
+  WRITE,
+  /** Appends to the log. */
+  LOG_WRITE,
+  /** Flushes of the log to its file, which WriteLog waits for before it returns. */
+  SYNC,
+  NUM_OPERATIONS
+};
+
+/** The subsystem an I/O was done for. */
+enum class IOTag {
+  /** I/O done outside of any IOTagScope. */
+  OTHER,
+  TABLE_HEAP,
+  HASH_INDEX,
+  TEMP,
+  LOG,
+  /** Dirty victims written back by the thread that evicts them. */
+  EVICTION,
+  PAGE_CLEANER,
+  PREFETCH,
+  NUM_TAGS
+};
+
+/** @return the name of an operation, e.g. "read" */
+const char *IOOperationName(IOOperation operation);
+
+/** @return the name of a tag, e.g. "table_heap" */
+const char *IOTagName(IOTag tag);
+
+/**
+ * IOTagScope tags the I/O the calling thread does while the scope is alive, including I/O the buffer pool does on its
+ * behalf, e.g. to read a page it fetches. Scopes nest: the innermost one wins, and the tag of the enclosing scope comes
+ * back when it ends. Asynchronous I/O keeps the tag of the thread that started it.
+ */
+class IOTagScope {
+ public:
+  /** @param tag the tag of the I/O done in this scope */
+  explicit IOTagScope(IOTag tag) : previous_(current) { current = tag; }
+
+  /** Restores the tag of the enclosing scope. */
+  ~IOTagScope() { current = previous_; }
+
+  DISALLOW_COPY_AND_MOVE(IOTagScope);
+
+  /** @return the tag of the calling thread's innermost scope, OTHER if there is none */
+  static IOTag Current() { return current; }
+
+ private:
+  static thread_local IOTag current;
+  IOTag previous_;
+};
+
+/** A point-in-time copy of the I/Os of one kind: how many, how large and how long they took. */
+struct IOHistogram {
+  /** Number of latency buckets. Bucket 0 counts I/Os under 1 us, bucket i under 2^i us, the last one the rest. */
+  static constexpr size_t NUM_BUCKETS = 32;
+
+  uint64_t count_{0};
+  uint64_t bytes_{0};
+  uint64_t total_ns_{0};
+  uint64_t buckets_[NUM_BUCKETS]{};
+
+  /** @return the mean latency in microseconds, 0 if there were no I/Os */
+  double MeanMicros() const;
+
+  /**
+   * @param fraction the fraction of I/Os, e.g. 0.99
+   * @return a latency in microseconds that at least that fraction of the I/Os did not exceed, rounded up to a bucket
+   * boundary; 0 if there were no I/Os
+   */
+  uint64_t PercentileMicros(double fraction) const;
+
+  /** Adds the I/Os of another histogram to these. */
+  IOHistogram &operator+=(const IOHistogram &other);
+};
+
+/** A point-in-time copy of the I/O statistics of a DiskManager, per operation and tag. */
+struct DiskIOCounters {
+  IOHistogram histograms_[static_cast<size_t>(IOOperation::NUM_OPERATIONS)][static_cast<size_t>(IOTag::NUM_TAGS)];
+
+  /** @return the I/Os of one operation, whatever their tag */
+  IOHistogram Get(IOOperation operation) const;
+
+  /** @return the I/Os of one operation done for one subsystem */
+  const IOHistogram &Get(IOOperation operation, IOTag tag) const {
+    return histograms_[static_cast<size_t>(operation)][static_cast<size_t>(tag)];
+  }
+
+  /** @return one line per operation and tag that saw any I/O, with its count, bytes and latency percentiles */
+  std::string ToString() const;
+};
+
+/**
+ * DiskIOStats collects the latency histograms and byte counts of the I/Os of a DiskManager, per operation and tag.
+ *
+ * An I/O takes microseconds at the very least, so the counters are plain atomics rather than striped per thread like
+ * those of BufferPoolStats. Reading the counters while I/O is in flight gives a snapshot that is not exact.
+ */
+class DiskIOStats {
+ public:
+  DiskIOStats() = default;
+
+  DISALLOW_COPY_AND_MOVE(DiskIOStats);
+
+  /**
+   * Counts a completed I/O.
+   * @param operation the kind of I/O
+   * @param tag the subsystem it was done for
+   * @param bytes the number of bytes transferred
+   * @param latency how long it took, from submission to completion for asynchronous I/O
+   */
+  void Record(IOOperation operation, IOTag tag, size_t bytes, std::chrono::steady_clock::duration latency);
+
+  /** @return the current value of every counter */
+  DiskIOCounters GetCounters() const;
+
+  /** Sets every counter back to zero. */
+  void Reset();
+
+ private:
+  struct Histogram {
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> total_ns_{0};
+    std::atomic<uint64_t> buckets_[IOHistogram::NUM_BUCKETS]{};
+  };
+
+  Histogram histograms_[static_cast<size_t>(IOOperation::NUM_OPERATIONS)][static_cast<size_t>(IOTag::NUM_TAGS)];
+};
+
+}  // namespace bustub
@@ -12,54 +12,123 @@
 
 #pragma once
 
+#include <sys/types.h>
+#include <sys/uio.h>
+
 #include <atomic>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/async_disk_io.h"
+#include "storage/disk/disk_io_stats.h"
+#include "storage/disk/free_space_map.h"
 
 namespace bustub {
 
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ * Pages are read and written at their own offsets, so any number of threads can do I/O on different pages at once.
+ * The I/O methods are virtual, so that e.g. the in-memory DiskManagerMemory can be used wherever a DiskManager is.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io true to bypass the page cache with O_DIRECT, so that the buffer pool is the only cache; ignored,
+   * with a warning, if the file system does not support it or the page size is not a multiple of DIRECT_IO_ALIGNMENT
+   * @param page_size the size of every page of the file, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE; it is
+   * not recorded in the file, so it must be the same every time the file is opened
+   */
+  explicit DiskManager(const std::string &db_file, bool direct_io = false, size_t page_size = PAGE_SIZE);
+
+  /**
+   * Creates a new disk manager that stripes the pages of the database over several files, e.g. one per device, so that
+   * I/O spreads over all of them. Page ids are laid out in stripes of STRIPE_SIZE consecutive pages, which go to the
+   * files in turn, and each file has its own asynchronous backend.
+   * @param db_files the file names of the database files, at least one, in the same order every time the tablespace
+   * is opened; the first also names the log file and the free space map
+   * @param direct_io true to bypass the page cache with O_DIRECT; ignored, with a warning, unless every file supports
+   * it and the page size is a multiple of DIRECT_IO_ALIGNMENT
+   * @param page_size the size of the pages of the files, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE
+   * @throws Exception if a file holds more pages than there are page ids
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::vector<std::string> &db_files, bool direct_io = false, size_t page_size = PAGE_SIZE);
 
-  ~DiskManager() = default;
+  /** Waits for the asynchronous I/Os in flight and closes the files. */
+  virtual ~DiskManager();
 
   /**
-   * Shut down the disk manager and close all the file resources.
+   * Shut down the disk manager and close all the file resources. Asynchronous I/Os in flight are waited for first.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
-   * Write a page to the database file.
+   * Write a page to the database file. The write reaches the operating system before it returns, but is not synced;
+   * in direct I/O mode it reaches the device, but may still sit in its volatile write cache. A page reused from the
+   * free space map is not written until the map says on disk that it is in use, see FreeSpaceMap.
    * @param page_id id of the page
-   * @param page_data raw page data
+   * @param page_data raw page data; copied through an aligned buffer in direct I/O mode if it is not aligned to
+   * DIRECT_IO_ALIGNMENT
+   */
+  virtual void WritePage(page_id_t page_id, const char *page_data);
+
+  /**
+   * Write a batch of pages to the database file, e.g. for a checkpoint. The pages are written in page id order, each
+   * run of consecutive pages with a single gathering write straight from the callers' buffers. A run that fails does
+   * not stop the runs after it.
+   * @param[in,out] pages ids and raw data of the pages to write; sorted by page id on return
+   * @return the ids of the pages that could not be written, in page id order; empty if every page was written
    */
-  void WritePage(page_id_t page_id, const char *page_data);
+  virtual std::vector<page_id_t> WritePages(std::vector<std::pair<page_id_t, const char *>> *pages);
 
   /**
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data);
+  virtual void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * Starts reading a page and returns without waiting for it. The first call starts the asynchronous backend, see
+   * AsyncDiskIO::Create.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the callback runs; in direct I/O mode it must be
+   * aligned to DIRECT_IO_ALIGNMENT
+   * @param callback called on a backend thread once the page is read, with false on an I/O error; must not start I/O
+   */
+  virtual void ReadPageAsync(page_id_t page_id, char *page_data, std::function<void(bool)> callback);
+
+  /**
+   * Starts writing a page and returns without waiting for it.
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid and unchanged until the callback runs; in direct I/O mode it
+   * must be aligned to DIRECT_IO_ALIGNMENT
+   * @param callback called on a backend thread once the page is written, with false on an I/O error; must not start I/O
+   */
+  virtual void WritePageAsync(page_id_t page_id, const char *page_data, std::function<void(bool)> callback);
+
+  /** Waits until every asynchronous read and write started so far has completed. */
+  virtual void WaitForAsyncIO();
+
+  /** @return the name of the asynchronous backend, "io_uring" or "thread_pool" */
+  virtual const char *GetAsyncIOBackendName();
 
   /**
    * Append a log entry to the log file.
    * @param log_data raw log data
    * @param size size of log entry
    */
-  void WriteLog(char *log_data, int size);
+  virtual void WriteLog(char *log_data, int size);
 
   /**
    * Read a log entry from the log file.
@@ -68,20 +137,82 @@ class DiskManager {
    * @param offset offset of the log entry in the file
    * @return true if the read was successful, false otherwise
    */
-  bool ReadLog(char *log_data, int size, int offset);
+  virtual bool ReadLog(char *log_data, int size, int offset);
 
   /**
-   * Allocate a page on disk.
+   * Allocate a page on disk, reusing the lowest deallocated page if there is one. New page ids start after the last
+   * page of the db files, so a reopened database does not hand out the pages it already has.
    * @return the id of the allocated page
    */
   page_id_t AllocatePage();
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk, so that AllocatePage can reuse it. The page is recorded in a FreeSpaceMap kept in a .fsm
+   * file next to the db file. Deallocating a page that was never allocated, or that is deallocated already, does
+   * nothing.
    * @param page_id id of the page to deallocate
    */
   void DeallocatePage(page_id_t page_id);
 
+  /**
+   * Allocate a run of contiguous pages at the end of the file, e.g. for a PageExtent. Deallocated pages are not reused
+   * for extents, since they are seldom contiguous. In a striped tablespace the run starts on a stripe boundary, so that
+   * an extent, which is as long as a stripe, always lies within one file.
+   * @param num_pages the number of pages; at most STRIPE_SIZE in a striped tablespace, so that the run lies within one
+   * file
+   * @return the id of the first page of the run
+   */
+  page_id_t AllocateExtent(size_t num_pages);
+
+  /** @return the number of deallocated pages waiting to be reused */
+  size_t GetNumFreePages() const { return free_space_map_ == nullptr ? 0 : free_space_map_->GetNumFree(); }
+
+  /**
+   * @param page_size a page size, in bytes
+   * @return true if a file can use pages of that size: a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE
+   */
+  static bool IsValidPageSize(size_t page_size) {
+    return page_size >= MIN_PAGE_SIZE && page_size <= MAX_PAGE_SIZE && (page_size & (page_size - 1)) == 0;
+  }
+
+  /**
+   * @return the size of the pages of the db file, in bytes: PAGE_SIZE by default, larger for tables that are mostly
+   * scanned, smaller for dense index blocks. A buffer pool over the file holds frames of this size.
+   */
+  size_t GetPageSize() const { return page_size_; }
+
+  /** @return the number of db files the pages are striped over */
+  size_t GetNumFiles() const { return db_fds_.size(); }
+
+  /**
+   * @return true if the db file was opened with O_DIRECT. Buffer pool frames are always aligned for it; other buffers
+   * passed to the synchronous methods are copied through an aligned one, and those of the asynchronous ones must be
+   * aligned by the caller.
+   */
+  bool IsDirectIO() const { return direct_io_; }
+
+  /**
+   * Maps the db file, read-only, so that ReadPage copies pages out of the mapping instead of making a system call. The
+   * mapping follows the file as it grows. Writes still go through pwrite and share the page cache with the mapping, so
+   * reads see every write that has returned, and the buffer pool still decides when a page reaches the file. Must be
+   * called before the disk manager is shared between threads.
+   * @return false if the file cannot be mapped, e.g. because it was opened with O_DIRECT, which bypasses the page
+   * cache the mapping reads from, or because the pages are striped over several files
+   */
+  virtual bool EnableMappedReads();
+
+  /** @return true if ReadPage reads from a mapping of the db file */
+  bool IsMappedReads() const { return mapping_ != nullptr; }
+
+  /**
+   * @return the latency histograms and bytes transferred of the reads, writes and log flushes so far, per operation
+   * and per IOTag, the subsystem the calling thread was working for
+   */
+  DiskIOCounters GetIOStats() const { return io_stats_.GetCounters(); }
+
+  /** Sets the I/O statistics back to zero. */
+  void ResetIOStats() { io_stats_.Reset(); }
+
   /** @return the number of disk flushes */
   int GetNumFlushes() const;
 
@@ -100,19 +231,66 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
+ protected:
+  /**
+   * Creates a disk manager without any files, for implementations that keep the pages elsewhere.
+   * @param page_size the size of the pages, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE
+   */
+  explicit DiskManager(size_t page_size = PAGE_SIZE);
+
+  size_t page_size_;
+
+  std::atomic<page_id_t> next_page_id_{0};
+  int num_flushes_{0};
+  // page writes may come from background threads, e.g. the page cleaner, while the count is read
+  std::atomic<int> num_writes_{0};
+  bool flush_log_{false};
+  std::future<void> *flush_log_f_{nullptr};
+  DiskIOStats io_stats_;
+
  private:
-  int GetFileSize(const std::string &file_name);
+  /** @return the size of a file in bytes, -1 if it cannot be stat'ed */
+  int64_t GetFileSize(const std::string &file_name);
+  /**
+   * Writes the changes to the free space map, if any; called before any page is written.
+   * @return false if that failed, in which case the pages the map handed out since its last flush must not be written
+   */
+  bool FlushFreeSpaceMap();
+  bool WriteAt(int fd, const char *data, size_t size, off_t offset);
+  bool WriteRunAt(int fd, iovec *iov, size_t iov_count, off_t offset);
+  /** @return the page's number within its file, with the index of the file in file */
+  page_id_t GetLocalPage(page_id_t page_id, size_t *file) const;
+  /** @return the id of a page given its file and its number within the file */
+  page_id_t GetGlobalPage(size_t file, page_id_t local_page) const;
+  /** Maps the part of the file that is not mapped yet. @return the number of pages mapped now */
+  size_t ExtendMapping();
+  /** @return a callback that counts an asynchronous I/O started now, with the caller's tag, and then calls callback */
+  std::function<void(bool)> RecordOnCompletion(IOOperation operation, std::function<void(bool)> callback);
+  /** @return the asynchronous backend of a file, started if need be */
+  AsyncDiskIO *GetAsyncIO(size_t file);
+  // longest run of consecutive pages WritePages gathers into a single write
+  static constexpr size_t MAX_WRITE_RUN = 64;
+  // address space reserved for the mapping of the db file; pages beyond it are read with pread
+  static constexpr size_t MAX_MAPPED_SIZE = size_t{1} << 40;
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // descriptors of the db files, one per stripe, shared by synchronous and asynchronous I/O
+  std::vector<int> db_fds_;
+  // the descriptor was opened with O_DIRECT, so every buffer must be aligned
+  bool direct_io_{false};
+  // MAX_MAPPED_SIZE bytes of address space, of which the first mapped_pages_ pages map the db file; nullptr if reads
+  // are not mapped. The mapping only ever grows, in place, so readers never see it move.
+  char *mapping_{nullptr};
+  std::atomic<size_t> mapped_pages_{0};
+  std::mutex mapping_latch_;
+  // one per db file, started with the first asynchronous I/O to the file, so files that never use it do not pay for
+  // its threads
+  std::vector<std::unique_ptr<AsyncDiskIO>> async_io_;
+  std::mutex async_io_latch_;
   std::string file_name_;
-  std::atomic<page_id_t> next_page_id_;
-  int num_flushes_;
-  int num_writes_;
-  bool flush_log_;
-  std::future<void> *flush_log_f_;
+  // pages below next_page_id_ that have been deallocated, nullptr if the db file name has no extension
+  std::unique_ptr<FreeSpaceMap> free_space_map_;
 };
 
 }  // namespace bustub
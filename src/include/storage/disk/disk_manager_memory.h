@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory.h
+//
+// Identification: src/include/storage/disk/disk_manager_memory.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** The disk a DiskManagerMemory pretends to be. The default is a disk that takes no time at all. */
+struct SimulatedDisk {
+  /** Time every page read takes on top of its transfer. */
+  std::chrono::nanoseconds read_latency_{0};
+  /** Time every write, of a page, a batch of pages or the log, takes on top of its transfer. */
+  std::chrono::nanoseconds write_latency_{0};
+  /** Bytes per second the disk transfers, shared by every read and write in flight, 0 for no limit. */
+  uint64_t bandwidth_{0};
+};
+
+/**
+ * DiskManagerMemory keeps the pages and the log of a database in memory, so that the buffer pool, the indexes and the
+ * executors can be benchmarked without the noise of file I/O.
+ *
+ * It can also pretend to be a slow disk. Every request waits for a fixed latency, and for its bytes to go through a
+ * device with a fixed bandwidth that all requests queue for, so a slow disk is modelled the same way on every run. The
+ * waits are timed with the steady clock, sleeping for long waits and spinning for the end of each, so that short
+ * latencies are not rounded up to the scheduler's granularity.
+ *
+ * Asynchronous reads and writes are done one at a time by a backend thread, which also runs their callbacks, like the
+ * file backends do. Deallocated pages are not reused.
+ */
+class DiskManagerMemory : public DiskManager {
+ public:
+  /**
+   * @param disk the latency and bandwidth to simulate
+   * @param page_size the size of the pages, a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE
+   */
+  explicit DiskManagerMemory(const SimulatedDisk &disk = SimulatedDisk(), size_t page_size = PAGE_SIZE)
+      : DiskManager(page_size), disk_(disk) {}
+
+  /** Waits for the asynchronous reads and writes in flight and stops the backend thread. */
+  ~DiskManagerMemory() override;
+
+  void ShutDown() override { WaitForAsyncIO(); }
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /** Writes the batch as one request, which waits for the write latency once. */
+  std::vector<page_id_t> WritePages(std::vector<std::pair<page_id_t, const char *>> *pages) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void ReadPageAsync(page_id_t page_id, char *page_data, std::function<void(bool)> callback) override;
+
+  void WritePageAsync(page_id_t page_id, const char *page_data, std::function<void(bool)> callback) override;
+
+  void WaitForAsyncIO() override;
+
+  /** @return "memory" */
+  const char *GetAsyncIOBackendName() override { return "memory"; }
+
+  /** There is no file to map. */
+  bool EnableMappedReads() override { return false; }
+
+  void WriteLog(char *log_data, int size) override;
+
+  bool ReadLog(char *log_data, int size, int offset) override;
+
+  /** @return the total time requests have waited for the simulated disk */
+  std::chrono::nanoseconds GetSimulatedTime() const { return std::chrono::nanoseconds(simulated_ns_.load()); }
+
+ private:
+  /** Waits as long as the simulated disk takes for a request of the given size. */
+  void Simulate(std::chrono::nanoseconds latency, size_t bytes);
+
+  /** @return the data of a page, allocated if need be. Must be called with latch_ held. */
+  char *GetPage(page_id_t page_id);
+
+  /** Queues an asynchronous read or write for the backend thread, starting the thread on first use. */
+  void SubmitAsync(std::function<void()> request);
+
+  /** Runs the queued requests until the destructor stops it. */
+  void WorkAsync();
+
+  SimulatedDisk disk_;
+  /** The pages written so far, indexed by page id; never written pages are nullptr. Protected by latch_. */
+  std::vector<std::unique_ptr<char[]>> pages_;
+  std::mutex latch_;
+  /** The log. Protected by log_latch_. */
+  std::vector<char> log_;
+  std::mutex log_latch_;
+  /** When the simulated device is done with every transfer queued so far. Protected by device_latch_. */
+  std::chrono::steady_clock::time_point device_free_at_;
+  std::mutex device_latch_;
+  std::atomic<int64_t> simulated_ns_{0};
+  /** The asynchronous requests not started yet, and how many are not completed. Protected by async_latch_. */
+  std::deque<std::function<void()>> async_queue_;
+  size_t async_in_flight_{0};
+  bool async_stopped_{false};
+  std::mutex async_latch_;
+  /** Signalled when a request is queued, and when the last request in flight completes. */
+  std::condition_variable async_cv_;
+  std::thread async_worker_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/disk/free_space_map.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap remembers which pages of a database file have been deallocated, so that DiskManager can hand them out
+ * again instead of growing the file.
+ *
+ * The map is a bitmap with one bit per page, set while the page is free. It is kept in memory and persisted in a file
+ * of its own next to the database file, one PAGE_SIZE map page after the other, so that the page ids of the database
+ * file stay as they are. Changes only mark their map page dirty; Flush writes the dirty map pages, and the file is
+ * only created by the first Flush with something to write.
+ *
+ * DiskManager flushes the map before it writes any page. A flush syncs the map file, and a page taken out of the map
+ * is not written until a flush has succeeded, so the page is out of the map on disk before its data is in the database
+ * file, and a crash cannot hand it out twice. A page freed after the last flush is not free after a crash, which only
+ * leaks it.
+ *
+ * Take always returns the lowest free page, which keeps new pages close to the start of the file and to each other.
+ */
+class FreeSpaceMap {
+ public:
+  /** Number of pages one map page keeps track of. */
+  static constexpr size_t PAGES_PER_MAP_PAGE = PAGE_SIZE * 8;
+
+  /**
+   * Loads the map from its file, if there is one.
+   * @param file_name the file the map is kept in
+   * @param num_pages the number of pages in the database file; bits for pages beyond it, e.g. from a stale map of a
+   * database file that has since been recreated, are dropped
+   */
+  FreeSpaceMap(std::string file_name, page_id_t num_pages);
+
+  /** Closes the file of the map. */
+  ~FreeSpaceMap();
+
+  DISALLOW_COPY_AND_MOVE(FreeSpaceMap);
+
+  /**
+   * Takes a free page out of the map.
+   * @return the lowest free page, or INVALID_PAGE_ID if there is none
+   */
+  page_id_t Take();
+
+  /**
+   * Marks a page as free. Freeing a page that is free already does nothing.
+   * @param page_id the page
+   */
+  void Free(page_id_t page_id);
+
+  /** @return true if the page is free */
+  bool IsFree(page_id_t page_id);
+
+  /** @return the number of free pages */
+  size_t GetNumFree() const { return num_free_.load(std::memory_order_relaxed); }
+
+  /**
+   * Writes the map pages changed since the last flush to the file and syncs it. Cheap if nothing changed.
+   * @return false if the map could not be made durable, in which case the pages taken since the last successful flush
+   * must not be written yet
+   */
+  bool Flush();
+
+  /** @return true if the page was taken out of the map after the last successful flush */
+  bool IsTakenUnflushed(page_id_t page_id);
+
+  /** Flushes and closes the file. The map must not be changed afterwards. */
+  void Close();
+
+ private:
+  static constexpr size_t WORDS_PER_MAP_PAGE = PAGE_SIZE / sizeof(uint64_t);
+
+  /** Marks the map page holding a word as changed. Must be called with latch_ held. */
+  void MarkDirty(size_t word);
+
+  /** Writes the dirty map pages to the file and syncs it. Must be called with latch_ held. @return false on failure */
+  bool FlushDirty();
+
+  /** Writes a map page to the file. Must be called with latch_ held. @return false on an I/O error */
+  bool Persist(size_t map_page);
+
+  std::string file_name_;
+  /** The file of the map, -1 until it is opened or created. */
+  int fd_{-1};
+  bool closed_{false};
+  /** The bitmap, always a whole number of map pages. */
+  std::vector<uint64_t> words_;
+  /** Map pages changed since they were last written, indexed by map page. */
+  std::vector<bool> dirty_map_pages_;
+  /** Pages taken since the last successful flush, which must not be written before the next one. */
+  std::vector<page_id_t> unflushed_takes_;
+  /** True while any map page is dirty. Read without the latch, so that flushes skip it while nothing changed. */
+  std::atomic<bool> dirty_{false};
+  /** No word below this one has a free page. */
+  size_t first_free_word_{0};
+  /** Read without the latch, so that allocations skip it while nothing is free. */
+  std::atomic<size_t> num_free_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_extent.h
+//
+// Identification: src/include/storage/disk/page_extent.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class DiskManager;
+
+/**
+ * PageExtent gives the pages of one table heap or index a mostly sequential layout on disk.
+ *
+ * Instead of allocating one page at a time, interleaved with the pages of everybody else, the owner of an extent
+ * reserves extent_size contiguous pages from the DiskManager at once and creates its pages in them in order; once they
+ * are used up, the next extent is reserved. Pages of an extent that are never used stay reserved as long as the
+ * database runs; those at the end of the file are not in it, so they are handed out again after a restart.
+ *
+ * An extent is thread-safe, so it can be shared by everybody who adds pages to the same table heap or index.
+ */
+class PageExtent {
+ public:
+  /** @param extent_size the number of contiguous pages to reserve at once */
+  explicit PageExtent(size_t extent_size = EXTENT_SIZE) : extent_size_(extent_size) {}
+
+  ~PageExtent() = default;
+
+  DISALLOW_COPY_AND_MOVE(PageExtent);
+
+  /**
+   * Allocates the next page of the extent, reserving a new extent first if this one is used up.
+   * @param disk_manager the disk manager to reserve extents from
+   * @return the id of the allocated page
+   */
+  page_id_t AllocatePage(DiskManager *disk_manager);
+
+ private:
+  size_t extent_size_;
+  /** The next page to hand out, equal to end_ once the extent is used up. */
+  page_id_t next_{0};
+  /** The page after the last page of the extent. */
+  page_id_t end_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
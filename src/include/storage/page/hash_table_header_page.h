@@ -82,12 +82,12 @@ class HashTableHeaderPage {
    * @param index the index of the block
    * @return the page_id for the block.
    */
-  page_id_t GetBlockPageId(size_t index);
+  page_id_t GetBlockPageId(size_t index) const;
 
   /**
    * @return the number of blocks currently stored in the header page
    */
-  size_t NumBlocks();
+  size_t NumBlocks() const;
 
  private:
   __attribute__((unused)) lsn_t lsn_;
@@ -14,6 +14,7 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
+// The hash table page layouts are sized for PAGE_SIZE pages, the smallest page size a file may use.
 #define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
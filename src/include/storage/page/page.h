@@ -12,8 +12,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <type_traits>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -24,14 +29,29 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The page data is not stored inline. A buffer pool keeps its Pages in a compact array of metadata pointing into a
+ * separate FrameArena, and each Page is aligned to a cache line so that the latches and pin counts of neighbouring
+ * frames never share one.
+ *
+ * Besides the read latch, a page can be read optimistically. The page keeps a version that the write latch makes odd
+ * while it is held and bumps back to even when it is released, like a seqlock. An optimistic reader takes no latch and
+ * writes nothing shared: it reads the version, reads the data, and checks that the version has not changed; if it
+ * has, the data it read may be torn and must be thrown away. This only protects against writers that hold the write
+ * latch, and the reader must not trust anything it read, e.g. follow an offset, before the read is validated.
+ *
+ * A writer may change the data while an optimistic reader copies it, so the reader must not read the data with plain
+ * loads, memcpy or the usual page accessors, which would be a data race. It copies what it needs with CopyOptimistic
+ * or LoadOptimistic, which use relaxed atomic loads: they may return bytes from before and after a write, which the
+ * validation catches, but the compiler cannot split, merge or repeat them the way it may plain loads.
  */
-class Page {
+class alignas(64) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
-  friend class BufferPoolManager;
+  friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor for a page that lives outside of any buffer pool. Allocates and zeros out the page data. */
+  Page() : owned_data_(new char[PAGE_SIZE]), data_(owned_data_.get()) { ResetMemory(); }
 
   /** Default destructor. */
   ~Page() = default;
@@ -39,20 +59,34 @@ class Page {
   /** @return the actual data contained within this page */
   inline char *GetData() { return data_; }
 
+  /** @return the actual data contained within this page, for reading */
+  inline const char *GetData() const { return data_; }
+
+  /** @return the size of the page data, the page size of the file the page belongs to */
+  inline size_t GetPageSize() const { return size_; }
+
   /** @return the page id of this page */
-  inline page_id_t GetPageId() { return page_id_; }
+  inline page_id_t GetPageId() { return page_id_.load(std::memory_order_acquire); }
 
   /** @return the pin count of this page */
-  inline int GetPinCount() { return pin_count_; }
+  inline int GetPinCount() { return std::max(pin_count_.load(std::memory_order_acquire), 0); }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
-  inline bool IsDirty() { return is_dirty_; }
+  inline bool IsDirty() { return is_dirty_.load(std::memory_order_relaxed); }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    // The odd version must be visible before any of the writer's changes to the data.
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,6 +94,75 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Starts an optimistic read of the page data.
+   * @return the version to validate the read against; odd if a writer holds the latch, in which case the read fails
+   */
+  inline uint64_t BeginOptimisticRead() const { return version_.load(std::memory_order_acquire); }
+
+  /**
+   * @param version the version BeginOptimisticRead returned
+   * @return true if no writer held the latch at any point since BeginOptimisticRead, i.e. what was read is consistent
+   */
+  inline bool ValidateOptimisticRead(uint64_t version) const {
+    // Keeps the relaxed loads of the data from moving past the second load of the version.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (version & 1) == 0 && version_.load(std::memory_order_acquire) == version;
+  }
+
+  /**
+   * Copies page data during an optimistic read, with relaxed atomic loads of the largest aligned words it can.
+   * @param dst where to copy to, memory the reader owns
+   * @param src the page data to copy from
+   * @param size the number of bytes to copy
+   */
+  static inline void CopyOptimistic(void *dst, const char *src, size_t size) {
+    auto *out = static_cast<char *>(dst);
+    size_t i = 0;
+    for (; i < size && reinterpret_cast<uintptr_t>(src + i) % sizeof(uint64_t) != 0; i++) {
+      out[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+    }
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word = __atomic_load_n(reinterpret_cast<const uint64_t *>(src + i), __ATOMIC_RELAXED);
+      memcpy(out + i, &word, sizeof(uint64_t));
+    }
+    for (; i < size; i++) {
+      out[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+    }
+  }
+
+  /** @return the T at src in the page data, read during an optimistic read; see CopyOptimistic */
+  template <typename T>
+  static inline T LoadOptimistic(const char *src) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value;
+    CopyOptimistic(&value, src, sizeof(T));
+    return value;
+  }
+
+  /**
+   * Runs a reader over the page data until it sees a consistent page. The reader is retried optimistically up to
+   * OPTIMISTIC_READ_RETRIES times, and then once more under the read latch, so it must have no side effects other than
+   * overwriting its results. It must read the page data through CopyOptimistic or LoadOptimistic.
+   * @param reader called with no arguments, reads the page data
+   */
+  template <typename Reader>
+  inline void ReadOptimistic(Reader &&reader) {
+    for (int attempt = 0; attempt < OPTIMISTIC_READ_RETRIES; attempt++) {
+      uint64_t version = BeginOptimisticRead();
+      if ((version & 1) != 0) {
+        continue;
+      }
+      reader();
+      if (ValidateOptimisticRead(version)) {
+        return;
+      }
+    }
+    RLatch();
+    reader();
+    RUnlatch();
+  }
+
   /** @return the page LSN. */
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -75,19 +178,40 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /**
+   * Constructor for a buffer pool frame.
+   * @param data the frame's data in the pool's arena, already zeroed
+   * @param size the size of the frame
+   */
+  Page(char *data, size_t size) : data_(data), size_(size) {}
+
   /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, size_); }
 
+  /** The data of a page that does not belong to a buffer pool. */
+  std::unique_ptr<char[]> owned_data_;
   /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
-  /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
-  /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  char *data_;
+  /** The size of the data. */
+  size_t size_{PAGE_SIZE};
+  /** The ID of this page. Only changes while the frame is held exclusively by the buffer pool (pin count < 0). */
+  std::atomic<page_id_t> page_id_{INVALID_PAGE_ID};
+  /**
+   * The pin count of this page. The buffer pool pins resident pages with a compare-and-swap, without its latch; a
+   * negative count marks a frame that is free, or is being evicted, loaded or deleted, and cannot be pinned.
+   */
+  std::atomic<int> pin_count_{0};
+  /**
+   * True if the page is dirty, i.e. it is different from its corresponding page on disk. Set by unpins without the
+   * buffer pool latch, before they drop their pin, and cleared before the page is written back.
+   */
+  std::atomic<bool> is_dirty_{false};
+  /** True if the page was read ahead and nobody has fetched it since. */
+  std::atomic<bool> prefetched_{false};
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Seqlock version for optimistic reads, odd while the write latch is held. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -0,0 +1,235 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.h
+//
+// Identification: src/include/storage/page/page_guard.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <type_traits>
+
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+class ReadPageGuard;
+class WritePageGuard;
+
+/**
+ * BasicPageGuard holds the pin on a page fetched from a buffer pool and unpins it when it is dropped or destroyed, so a
+ * pin can no longer leak on an early return. The guard remembers whether the page was modified through it and passes
+ * the dirty flag on to UnpinPage.
+ *
+ * Guards are move-only; moving a guard transfers the pin. A default-constructed or moved-from guard, or one whose
+ * fetch failed, is empty and converts to false.
+ */
+class BasicPageGuard {
+ public:
+  BasicPageGuard() = default;
+
+  /**
+   * Takes over a pin on a page.
+   * @param bpm the buffer pool the page was fetched from
+   * @param page the pinned page, or nullptr for an empty guard
+   */
+  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+
+  BasicPageGuard(const BasicPageGuard &) = delete;
+  BasicPageGuard &operator=(const BasicPageGuard &) = delete;
+
+  /** Moves the pin of another guard into a new one, leaving the other guard empty. */
+  BasicPageGuard(BasicPageGuard &&that) noexcept;
+
+  /** Drops this guard's pin, then moves the pin of another guard into this one. */
+  BasicPageGuard &operator=(BasicPageGuard &&that) noexcept;
+
+  /** Drops the pin, if any. */
+  ~BasicPageGuard() { Drop(); }
+
+  /** Unpins the page, marking it dirty if it was modified, and empties the guard. Does nothing on an empty guard. */
+  void Drop();
+
+  /** @return true if the guard holds a page */
+  explicit operator bool() const { return page_ != nullptr; }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() { return page_->GetPageId(); }
+
+  /** @return the data of the guarded page, for reading */
+  const char *GetData() { return page_->GetData(); }
+
+  /** @return the data of the guarded page, for writing; the page will be unpinned as dirty */
+  char *GetDataMut() {
+    is_dirty_ = true;
+    return page_->GetData();
+  }
+
+  /**
+   * Views the guarded page as a T, either a Page subclass such as TablePage or a layout over the page data such as
+   * HashTableHeaderPage. Changes made through the result do not mark the page dirty; use AsMut or SetDirty for that.
+   * A layout must fit in the page.
+   */
+  template <class T>
+  T *As() {
+    if constexpr (std::is_base_of_v<Page, T>) {
+      return static_cast<T *>(page_);
+    } else {
+      BUSTUB_ASSERT(sizeof(T) <= page_->GetPageSize(), "page layout is larger than the page");
+      return reinterpret_cast<T *>(page_->GetData());
+    }
+  }
+
+  /** Views the guarded page as a T, for writing; the page will be unpinned as dirty. */
+  template <class T>
+  T *AsMut() {
+    is_dirty_ = true;
+    return As<T>();
+  }
+
+  /**
+   * Reads the guarded page as a T without taking its read latch, e.g. to look up a block in a HashTableHeaderPage. See
+   * Page::ReadOptimistic: the reader may run more than once and may see torn data on all but its last run, and it must
+   * read the page through Page::CopyOptimistic or Page::LoadOptimistic.
+   * @param reader called with a const T *
+   */
+  template <class T, class Reader>
+  void ReadOptimistic(Reader &&reader) {
+    const T *view = As<T>();
+    page_->ReadOptimistic([&] { reader(view); });
+  }
+
+  /** Marks the page as modified, e.g. once a change made through As turned out to succeed. */
+  void SetDirty() { is_dirty_ = true; }
+
+  /** Takes the page's read latch and moves the pin into a ReadPageGuard, leaving this guard empty. */
+  ReadPageGuard UpgradeRead();
+
+  /** Takes the page's write latch and moves the pin into a WritePageGuard, leaving this guard empty. */
+  WritePageGuard UpgradeWrite();
+
+ private:
+  friend class ReadPageGuard;
+  friend class WritePageGuard;
+
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+  bool is_dirty_{false};
+};
+
+/**
+ * ReadPageGuard holds a pin and the read latch on a page, and releases both when it is dropped or destroyed.
+ */
+class ReadPageGuard {
+ public:
+  ReadPageGuard() = default;
+
+  /**
+   * Takes over a pin on a page whose read latch is already held.
+   * @param bpm the buffer pool the page was fetched from
+   * @param page the pinned and read-latched page, or nullptr for an empty guard
+   */
+  ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  ReadPageGuard(const ReadPageGuard &) = delete;
+  ReadPageGuard &operator=(const ReadPageGuard &) = delete;
+  ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+
+  /** Drops this guard's latch and pin, then moves those of another guard into this one. */
+  ReadPageGuard &operator=(ReadPageGuard &&that) noexcept;
+
+  /** Drops the latch and pin, if any. */
+  ~ReadPageGuard() { Drop(); }
+
+  /** Releases the read latch, unpins the page and empties the guard. Does nothing on an empty guard. */
+  void Drop();
+
+  /** @return true if the guard holds a page */
+  explicit operator bool() const { return static_cast<bool>(guard_); }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() { return guard_.PageId(); }
+
+  /** @return the data of the guarded page */
+  const char *GetData() { return guard_.GetData(); }
+
+  /** Views the guarded page as a const T; see BasicPageGuard::As. Only a WritePageGuard gives a view for writing. */
+  template <class T>
+  const T *As() {
+    return guard_.As<T>();
+  }
+
+ private:
+  friend class BasicPageGuard;
+
+  BasicPageGuard guard_;
+};
+
+/**
+ * WritePageGuard holds a pin and the write latch on a page, and releases both when it is dropped or destroyed.
+ */
+class WritePageGuard {
+ public:
+  WritePageGuard() = default;
+
+  /**
+   * Takes over a pin on a page whose write latch is already held.
+   * @param bpm the buffer pool the page was fetched from
+   * @param page the pinned and write-latched page, or nullptr for an empty guard
+   */
+  WritePageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  WritePageGuard(const WritePageGuard &) = delete;
+  WritePageGuard &operator=(const WritePageGuard &) = delete;
+  WritePageGuard(WritePageGuard &&that) noexcept = default;
+
+  /** Drops this guard's latch and pin, then moves those of another guard into this one. */
+  WritePageGuard &operator=(WritePageGuard &&that) noexcept;
+
+  /** Drops the latch and pin, if any. */
+  ~WritePageGuard() { Drop(); }
+
+  /** Releases the write latch, unpins the page and empties the guard. Does nothing on an empty guard. */
+  void Drop();
+
+  /** @return true if the guard holds a page */
+  explicit operator bool() const { return static_cast<bool>(guard_); }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() { return guard_.PageId(); }
+
+  /** @return the data of the guarded page, for reading */
+  const char *GetData() { return guard_.GetData(); }
+
+  /** @return the data of the guarded page, for writing; the page will be unpinned as dirty */
+  char *GetDataMut() { return guard_.GetDataMut(); }
+
+  /** Views the guarded page as a T; see BasicPageGuard::As. */
+  template <class T>
+  T *As() {
+    return guard_.As<T>();
+  }
+
+  /** Views the guarded page as a T, for writing; the page will be unpinned as dirty. */
+  template <class T>
+  T *AsMut() {
+    return guard_.AsMut<T>();
+  }
+
+  /** Marks the page as modified. */
+  void SetDirty() { guard_.SetDirty(); }
+
+ private:
+  friend class BasicPageGuard;
+
+  BasicPageGuard guard_;
+};
+
+}  // namespace bustub
@@ -54,13 +54,13 @@ class TablePage : public Page {
   void Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_id, LogManager *log_manager, Transaction *txn);
 
   /** @return the page ID of this table page */
-  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+  page_id_t GetTablePageId() const { return *reinterpret_cast<const page_id_t *>(GetData()); }
 
   /** @return the page ID of the previous table page */
-  page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+  page_id_t GetPrevPageId() const { return *reinterpret_cast<const page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
 
   /** @return the page ID of the next table page */
-  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+  page_id_t GetNextPageId() const { return *reinterpret_cast<const page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
 
   /** Set the page id of the previous page in the table. */
   void SetPrevPageId(page_id_t prev_page_id) {
@@ -120,7 +120,16 @@ class TablePage : public Page {
    * @param lock_manager the lock manager
    * @return true if the read is successful (i.e. the tuple exists)
    */
-  bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
+  bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) const;
+
+  /**
+   * Read a tuple from a table without the page latch or a lock, as the reader of Page::ReadOptimistic. The result is
+   * only meaningful once the read is validated.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTupleOptimistic(const RID &rid, Tuple *tuple) const;
 
   /** @return the rid of the first tuple in this page */
 
@@ -128,14 +137,14 @@ class TablePage : public Page {
    * @param[out] first_rid the RID of the first tuple in this page
    * @return true if the first tuple exists, false otherwise
    */
-  bool GetFirstTupleRid(RID *first_rid);
+  bool GetFirstTupleRid(RID *first_rid) const;
 
   /**
    * @param cur_rid the RID of the current tuple
    * @param[out] next_rid the RID of the tuple following the current tuple
    * @return true if the next tuple exists, false otherwise
    */
-  bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
+  bool GetNextTupleRid(const RID &cur_rid, RID *next_rid) const;
 
  private:
   static_assert(sizeof(page_id_t) == 4);
@@ -150,7 +159,7 @@ class TablePage : public Page {
   static constexpr size_t OFFSET_TUPLE_SIZE = 28;
 
   /** @return pointer to the end of the current free space, see header comment */
-  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+  uint32_t GetFreeSpacePointer() const { return *reinterpret_cast<const uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
   /** Sets the pointer, this should be the end of the current free space. */
   void SetFreeSpacePointer(uint32_t free_space_pointer) {
@@ -161,18 +170,18 @@ class TablePage : public Page {
    * @note returned tuple count may be an overestimate because some slots may be empty
    * @return at least the number of tuples in this page
    */
-  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+  uint32_t GetTupleCount() const { return *reinterpret_cast<const uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
 
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
+  uint32_t GetFreeSpaceRemaining() const {
     return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
   }
 
   /** @return tuple offset at slot slot_num */
-  uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
-    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
+  uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) const {
+    return *reinterpret_cast<const uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
   }
 
   /** Set tuple offset at slot slot_num. */
@@ -181,8 +190,8 @@ class TablePage : public Page {
   }
 
   /** @return tuple size at slot slot_num */
-  uint32_t GetTupleSize(uint32_t slot_num) {
-    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num);
+  uint32_t GetTupleSize(uint32_t slot_num) const {
+    return *reinterpret_cast<const uint32_t *>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num);
   }
 
   /** Set tuple size at slot slot_num. */
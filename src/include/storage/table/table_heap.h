@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <memory>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/disk/page_extent.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
@@ -22,7 +25,8 @@ namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages, each the page size of its buffer pool, so a table that is mostly scanned
+ * can be kept in a file with large pages.
  */
 class TableHeap {
   friend class TableIterator;
@@ -91,7 +95,8 @@ class TableHeap {
   void RollbackDelete(const RID &rid, Transaction *txn);
 
   /**
-   * Read a tuple from the table.
+   * Read a tuple from the table. Unless logging is enabled, which needs a lock on the tuple, the page is read
+   * optimistically, without its latch.
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
    * @param txn transaction performing the read
@@ -99,8 +104,12 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
-  /** @return the begin iterator of this table */
-  TableIterator Begin(Transaction *txn);
+  /**
+   * @param txn the transaction performing the scan
+   * @param strategy if not nullptr, the scan recycles this private ring of frames instead of flooding the shared pool
+   * @return the begin iterator of this table
+   */
+  TableIterator Begin(Transaction *txn, BufferAccessStrategy *strategy = nullptr);
 
   /** @return the end iterator of this table */
   TableIterator End();
@@ -109,10 +118,20 @@ class TableHeap {
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
  private:
+  /**
+   * Asks the buffer pool to read pages of the table in the background, following the chain of pages.
+   * @param page_id the first page to read ahead, INVALID_PAGE_ID at the end of the table
+   * @param num_pages the number of pages to read
+   * @return how far the prefetcher has got with the request, nullptr if there is nothing to read
+   */
+  std::shared_ptr<ReadAheadWindow> ReadAhead(page_id_t page_id, size_t num_pages);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /** New pages of the table are created in extents, so that a scan of the table reads the disk mostly sequentially. */
+  PageExtent extent_;
 };
 
 }  // namespace bustub
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <memory>
 
+#include "buffer/buffer_access_strategy.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -22,6 +25,21 @@ namespace bustub {
 
 class TableHeap;
 
+/** How far the prefetcher has followed the chain of pages of one read-ahead request of a scan. */
+struct ReadAheadWindow {
+  ReadAheadWindow(page_id_t first_page_id, size_t num_pages) : last_page_id_(first_page_id), num_pages_(num_pages) {}
+
+  /** @return true once the ids of all the pages of the window are known, the last one being last_page_id_ */
+  bool IsComplete() const { return known_pages_.load(std::memory_order_acquire) == num_pages_; }
+
+  /** The last page of the window whose id is known. */
+  std::atomic<page_id_t> last_page_id_;
+  /** The number of pages of the window whose ids are known, counting from its first page. */
+  std::atomic<size_t> known_pages_{1};
+  /** The number of pages the request reads. */
+  const size_t num_pages_;
+};
+
 /**
  * TableIterator enables the sequential scan of a TableHeap.
  */
@@ -29,7 +47,16 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  /**
+   * Creates an iterator positioned at the given tuple.
+   * @param table_heap the table to iterate over
+   * @param rid the tuple to start at
+   * @param txn the transaction performing the scan
+   * @param strategy if not nullptr, pages are read through this ring instead of the shared pool
+   * @param read_ahead the read-ahead request already queued for the pages after the one of rid, if any
+   */
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferAccessStrategy *strategy = nullptr,
+                std::shared_ptr<ReadAheadWindow> read_ahead = nullptr);
 
   ~TableIterator() { delete tuple_; }
 
@@ -49,6 +76,11 @@ class TableIterator {
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  BufferAccessStrategy *strategy_;
+  /** Pages after the current one that are queued for read-ahead; the next window is queued once half are left. */
+  size_t read_ahead_pages_;
+  /** The last read-ahead request, which the next one continues from. */
+  std::shared_ptr<ReadAheadWindow> read_ahead_;
 };
 
 }  // namespace bustub
@@ -25,7 +25,8 @@ bool LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record)
 /*
  *redo phase on TABLE PAGE level(table/table_page.h)
  *read log file from the beginning to end (you must prefetch log records into
- *log buffer to reduce unnecessary I/O operations), remember to compare page's
+ *log buffer to reduce unnecessary I/O operations, log_buffer_size_ bytes at a
+ *time), remember to compare page's
  *LSN with log_record's sequence number, and also build active_txn_ table &
  *lsn_mapping_ table
  */
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_io_stats.cpp
+//
+// Identification: src/storage/disk/disk_io_stats.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_io_stats.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace bustub {
+
+thread_local IOTag IOTagScope::current = IOTag::OTHER;
+
+namespace {
+
+constexpr size_t NUM_OPERATIONS = static_cast<size_t>(IOOperation::NUM_OPERATIONS);
+constexpr size_t NUM_TAGS = static_cast<size_t>(IOTag::NUM_TAGS);
+
+/** @return the bucket of a latency: 0 under 1 us, i under 2^i us */
+size_t GetBucket(uint64_t latency_ns) {
+  uint64_t micros = latency_ns / 1000;
+  size_t bucket = 0;
+  while (micros != 0 && bucket < IOHistogram::NUM_BUCKETS - 1) {
+    micros >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+const char *IOOperationName(IOOperation operation) {
+  switch (operation) {
+    case IOOperation::READ:
+      return "read";
+    case IOOperation::MAPPED_READ:
+      return "mapped_read";
+    case IOOperation::WRITE:
+      return "write";
+    case IOOperation::LOG_WRITE:
+      return "log_write";
+    case IOOperation::SYNC:
+      return "sync";
+    default:
+      return "unknown";
+  }
+}
+
+const char *IOTagName(IOTag tag) {
+  switch (tag) {
+    case IOTag::OTHER:
+      return "other";
+    case IOTag::TABLE_HEAP:
+      return "table_heap";
+    case IOTag::HASH_INDEX:
+      return "hash_index";
+    case IOTag::TEMP:
+      return "temp";
+    case IOTag::LOG:
+      return "log";
+    case IOTag::EVICTION:
+      return "eviction";
+    case IOTag::PAGE_CLEANER:
+      return "page_cleaner";
+    case IOTag::PREFETCH:
+      return "prefetch";
+    default:
+      return "unknown";
+  }
+}
+
+double IOHistogram::MeanMicros() const {
+  return count_ == 0 ? 0 : static_cast<double>(total_ns_) / static_cast<double>(count_) / 1000;
+}
+
+uint64_t IOHistogram::PercentileMicros(double fraction) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(count_) + 0.5));
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+    seen += buckets_[bucket];
+    if (seen >= rank) {
+      return uint64_t{1} << bucket;
+    }
+  }
+  return uint64_t{1} << (NUM_BUCKETS - 1);
+}
+
+IOHistogram &IOHistogram::operator+=(const IOHistogram &other) {
+  count_ += other.count_;
+  bytes_ += other.bytes_;
+  total_ns_ += other.total_ns_;
+  for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+    buckets_[bucket] += other.buckets_[bucket];
+  }
+  return *this;
+}
+
+IOHistogram DiskIOCounters::Get(IOOperation operation) const {
+  IOHistogram sum;
+  for (const auto &histogram : histograms_[static_cast<size_t>(operation)]) {
+    sum += histogram;
+  }
+  return sum;
+}
+
+std::string DiskIOCounters::ToString() const {
+  std::stringstream os;
+  for (size_t operation = 0; operation < NUM_OPERATIONS; operation++) {
+    for (size_t tag = 0; tag < NUM_TAGS; tag++) {
+      const IOHistogram &histogram = histograms_[operation][tag];
+      if (histogram.count_ == 0) {
+        continue;
+      }
+      os << IOOperationName(static_cast<IOOperation>(operation)) << "." << IOTagName(static_cast<IOTag>(tag))
+         << ": count " << histogram.count_ << ", bytes " << histogram.bytes_ << ", mean_us " << histogram.MeanMicros()
+         << ", p50_us " << histogram.PercentileMicros(0.5) << ", p99_us " << histogram.PercentileMicros(0.99)
+         << ", p999_us " << histogram.PercentileMicros(0.999) << "\n";
+    }
+  }
+  return os.str();
+}
+
+void DiskIOStats::Record(IOOperation operation, IOTag tag, size_t bytes, std::chrono::steady_clock::duration latency) {
+  auto latency_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+  Histogram &histogram = histograms_[static_cast<size_t>(operation)][static_cast<size_t>(tag)];
+  histogram.count_.fetch_add(1, std::memory_order_relaxed);
+  histogram.bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  histogram.total_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+  histogram.buckets_[GetBucket(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+DiskIOCounters DiskIOStats::GetCounters() const {
+  DiskIOCounters counters;
+  for (size_t operation = 0; operation < NUM_OPERATIONS; operation++) {
+    for (size_t tag = 0; tag < NUM_TAGS; tag++) {
+      const Histogram &histogram = histograms_[operation][tag];
+      IOHistogram &copy = counters.histograms_[operation][tag];
+      copy.count_ = histogram.count_.load(std::memory_order_relaxed);
+      copy.bytes_ = histogram.bytes_.load(std::memory_order_relaxed);
+      copy.total_ns_ = histogram.total_ns_.load(std::memory_order_relaxed);
+      for (size_t bucket = 0; bucket < IOHistogram::NUM_BUCKETS; bucket++) {
+        copy.buckets_[bucket] = histogram.buckets_[bucket].load(std::memory_order_relaxed);
+      }
+    }
+  }
+  return counters;
+}
+
+void DiskIOStats::Reset() {
+  for (auto &histograms : histograms_) {
+    for (auto &histogram : histograms) {
+      histogram.count_.store(0, std::memory_order_relaxed);
+      histogram.bytes_.store(0, std::memory_order_relaxed);
+      histogram.total_ns_.store(0, std::memory_order_relaxed);
+      for (auto &bucket : histogram.buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+}  // namespace bustub
@@ -10,26 +10,74 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <chrono>  // NOLINT
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
 
+#include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
 
 static char *buffer_used;
 
+namespace {
+
+/** @return true if the buffer can be handed to O_DIRECT I/O as is */
+bool IsAligned(const char *data) { return reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0; }
+
+/** Memory aligned for O_DIRECT, to copy the pages of callers whose buffers are not. */
+class AlignedBuffer {
+ public:
+  explicit AlignedBuffer(size_t size)
+      : data_(static_cast<char *>(::operator new[](size, std::align_val_t{DIRECT_IO_ALIGNMENT}))) {}
+  ~AlignedBuffer() { ::operator delete[](data_, std::align_val_t{DIRECT_IO_ALIGNMENT}); }
+  DISALLOW_COPY_AND_MOVE(AlignedBuffer);
+  char *Get() { return data_; }
+
+ private:
+  char *data_;
+};
+
+/** @return this thread's aligned page for ReadPage and WritePage, large enough for any page size */
+char *BouncePage() {
+  thread_local AlignedBuffer page(MAX_PAGE_SIZE);
+  return page.Get();
+}
+
+}  // namespace
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io, size_t page_size)
+    : DiskManager(std::vector<std::string>{db_file}, direct_io, page_size) {}
+
+/**
+ * Constructor: open/create the database files of a striped tablespace & the log file
+ * @input db_files: database file names, the first of which also names the log and free space map
+ */
+DiskManager::DiskManager(const std::vector<std::string> &db_files, bool direct_io, size_t page_size)
+    : page_size_(page_size), db_fds_(db_files.size(), -1), async_io_(db_files.size()), file_name_(db_files.at(0)) {
+  BUSTUB_ASSERT(IsValidPageSize(page_size), "page size must be a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE");
   std::string::size_type n = file_name_.find('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -48,24 +96,87 @@ DiskManager::DiskManager(const std::string &db_file)
     log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
   }
 
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  // the db files are read and written at explicit offsets, so any number of threads can share the descriptors
+  if (direct_io && page_size_ % DIRECT_IO_ALIGNMENT != 0) {
+    LOG_WARN("pages of %zu bytes cannot be read with O_DIRECT, using the page cache", page_size_);
+  } else if (direct_io) {
+    // either every file bypasses the page cache or none does, so that the buffers of all of them follow one rule
+    direct_io_ = true;
+    for (size_t file = 0; file < db_files.size() && direct_io_; file++) {
+      db_fds_[file] = open(db_files[file].c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+      if (db_fds_[file] < 0) {
+        LOG_WARN("cannot open db file %s with O_DIRECT, using the page cache: %s", db_files[file].c_str(),
+                 strerror(errno));
+        direct_io_ = false;
+      }
+    }
+    for (int &fd : db_fds_) {
+      if (!direct_io_ && fd >= 0) {
+        close(fd);
+        fd = -1;
+      }
+    }
+  }
+  for (size_t file = 0; file < db_files.size() && !direct_io_; file++) {
+    db_fds_[file] = open(db_files[file].c_str(), O_RDWR | O_CREAT, 0644);
+    if (db_fds_[file] < 0) {
+      LOG_DEBUG("cannot open db file %s: %s", db_files[file].c_str(), strerror(errno));
+    }
   }
+  // pages are allocated after the last page of any file, and the free space map only knows about the pages before it
+  for (size_t file = 0; file < db_files.size(); file++) {
+    if (int64_t file_size = GetFileSize(db_files[file]); file_size > 0) {
+      auto page_size = static_cast<int64_t>(page_size_);
+      int64_t last_page = (file_size + page_size - 1) / page_size - 1;
+      // the id of the last page, computed like GetGlobalPage but in 64 bits so that a huge file cannot wrap around
+      int64_t last_id = last_page;
+      if (db_files.size() > 1) {
+        auto stripe = last_page / STRIPE_SIZE * static_cast<int64_t>(db_files.size()) + static_cast<int64_t>(file);
+        last_id = stripe * STRIPE_SIZE + last_page % STRIPE_SIZE;
+      }
+      if (last_id >= std::numeric_limits<page_id_t>::max()) {
+        // the destructor does not run for a constructor that throws
+        ShutDown();
+        throw Exception(ExceptionType::OUT_OF_RANGE, "db file " + db_files[file] + " has more pages than page ids");
+      }
+      next_page_id_ = std::max(next_page_id_.load(), static_cast<page_id_t>(last_id) + 1);
+    }
+  }
+  free_space_map_ = std::make_unique<FreeSpaceMap>(file_name_.substr(0, n) + ".fsm", next_page_id_.load());
   buffer_used = nullptr;
 }
 
+DiskManager::DiskManager(size_t page_size) : page_size_(page_size) {
+  BUSTUB_ASSERT(IsValidPageSize(page_size), "page size must be a power of two between MIN_PAGE_SIZE and MAX_PAGE_SIZE");
+}
+
+DiskManager::~DiskManager() { ShutDown(); }
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  db_io_.close();
+  {
+    std::lock_guard<std::mutex> guard(async_io_latch_);
+    // the backends wait for the I/Os in flight before they go away
+    for (auto &async_io : async_io_) {
+      async_io.reset();
+    }
+    for (int &fd : db_fds_) {
+      if (fd >= 0) {
+        close(fd);
+        fd = -1;
+      }
+    }
+  }
+  if (free_space_map_ != nullptr) {
+    free_space_map_->Close();
+  }
+  if (mapping_ != nullptr) {
+    munmap(mapping_, MAX_MAPPED_SIZE);
+    mapping_ = nullptr;
+    mapped_pages_ = 0;
+  }
   log_io_.close();
 }
 
@@ -73,43 +184,245 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
+  if (!FlushFreeSpaceMap() && free_space_map_->IsTakenUnflushed(page_id)) {
+    LOG_DEBUG("cannot write page %d before the free space map that handed it out", page_id);
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  auto start = std::chrono::steady_clock::now();
+  num_writes_ += 1;
+  if (direct_io_ && !IsAligned(page_data)) {
+    page_data = static_cast<const char *>(memcpy(BouncePage(), page_data, page_size_));
+  }
+  size_t file;
+  page_id_t local_page = GetLocalPage(page_id, &file);
+  if (!WriteAt(db_fds_[file], page_data, page_size_, static_cast<off_t>(local_page) * page_size_)) {
+    LOG_DEBUG("I/O error while writing: %s", strerror(errno));
+  }
+  io_stats_.Record(IOOperation::WRITE, IOTagScope::Current(), page_size_, std::chrono::steady_clock::now() - start);
+}
+
+/**
+ * Write a batch of pages, each run of pages that are consecutive in one file with a single gathering write
+ */
+std::vector<page_id_t> DiskManager::WritePages(std::vector<std::pair<page_id_t, const char *>> *pages) {
+  std::vector<page_id_t> failed_pages;
+  if (pages->empty()) {
+    return failed_pages;
+  }
+  std::sort(pages->begin(), pages->end());
+  std::vector<std::pair<page_id_t, const char *>> writable_pages;
+  if (!FlushFreeSpaceMap()) {
+    // the pages handed out since the map was last flushed wait until it is; the others are written anyway
+    for (const auto &page : *pages) {
+      if (free_space_map_->IsTakenUnflushed(page.first)) {
+        failed_pages.push_back(page.first);
+      } else {
+        writable_pages.push_back(page);
+      }
+    }
+    pages = &writable_pages;
+  }
+  std::vector<iovec> run(MAX_WRITE_RUN);
+  // only allocated if a page of the batch is not aligned for O_DIRECT
+  std::unique_ptr<AlignedBuffer> bounce;
+  for (size_t start = 0; start < pages->size();) {
+    // extend the run while the next page is adjacent on disk, which it is not across a stripe boundary
+    size_t file;
+    page_id_t local_page = GetLocalPage((*pages)[start].first, &file);
+    size_t end = start + 1;
+    while (end < pages->size() && end - start < MAX_WRITE_RUN && (*pages)[end].first == (*pages)[end - 1].first + 1 &&
+           (db_fds_.size() == 1 || (*pages)[end].first % STRIPE_SIZE != 0)) {
+      end++;
+    }
+    size_t run_length = end - start;
+    auto run_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < run_length; i++) {
+      const char *page_data = (*pages)[start + i].second;
+      if (direct_io_ && !IsAligned(page_data)) {
+        if (bounce == nullptr) {
+          bounce = std::make_unique<AlignedBuffer>(MAX_WRITE_RUN * page_size_);
+        }
+        page_data = static_cast<const char *>(memcpy(bounce->Get() + i * page_size_, page_data, page_size_));
+      }
+      run[i].iov_base = const_cast<char *>(page_data);
+      run[i].iov_len = page_size_;
+    }
+    num_writes_ += run_length;
+    // a failed run does not stop the batch: the other runs may well go to a file, or a part of one, that works
+    bool written = WriteRunAt(db_fds_[file], run.data(), run_length, static_cast<off_t>(local_page) * page_size_);
+    if (!written) {
+      LOG_DEBUG("I/O error while writing: %s", strerror(errno));
+      for (size_t i = start; i < end; i++) {
+        failed_pages.push_back((*pages)[i].first);
+      }
+    }
+    io_stats_.Record(IOOperation::WRITE, IOTagScope::Current(), written ? run_length * page_size_ : 0,
+                     std::chrono::steady_clock::now() - run_start);
+    start = end;
+  }
+  std::sort(failed_pages.begin(), failed_pages.end());
+  return failed_pages;
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error while reading");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+  if (direct_io_ && !IsAligned(page_data)) {
+    char *bounce = BouncePage();
+    ReadPage(page_id, bounce);
+    memcpy(page_data, bounce, page_size_);
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  if (mapping_ != nullptr) {
+    auto page = static_cast<size_t>(page_id);
+    if (page < mapped_pages_.load(std::memory_order_acquire) || page < ExtendMapping()) {
+      memcpy(page_data, mapping_ + page * page_size_, page_size_);
+      io_stats_.Record(IOOperation::MAPPED_READ, IOTagScope::Current(), page_size_,
+                       std::chrono::steady_clock::now() - start);
+      return;
+    }
+  }
+  size_t file;
+  off_t offset = static_cast<off_t>(GetLocalPage(page_id, &file)) * page_size_;
+  size_t read_count = 0;
+  while (read_count < page_size_) {
+    ssize_t result = pread(db_fds_[file], page_data + read_count, page_size_ - read_count, offset + read_count);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    read_count += result;
+  }
+  // if file ends before reading a whole page
+  if (read_count < page_size_) {
+    LOG_DEBUG("Read less than a page");
+    memset(page_data + read_count, 0, page_size_ - read_count);
+  }
+  io_stats_.Record(IOOperation::READ, IOTagScope::Current(), read_count, std::chrono::steady_clock::now() - start);
+}
+
+/**
+ * Map the db file for reading
+ */
+bool DiskManager::EnableMappedReads() {
+  if (mapping_ != nullptr) {
+    return true;
+  }
+  if (db_fds_.size() != 1 || db_fds_[0] < 0 || direct_io_) {
+    return false;
+  }
+  // Reserve the address space up front, so that the mapping can grow in place without moving under readers.
+  void *reserved = mmap(nullptr, MAX_MAPPED_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (reserved == MAP_FAILED) {
+    LOG_WARN("cannot reserve address space to map the db file: %s", strerror(errno));
+    return false;
+  }
+  mapping_ = static_cast<char *>(reserved);
+  ExtendMapping();
+  return true;
+}
+
+/**
+ * Map the pages the file gained since it was last mapped
+ */
+size_t DiskManager::ExtendMapping() {
+  std::lock_guard<std::mutex> guard(mapping_latch_);
+  size_t mapped_pages = mapped_pages_.load(std::memory_order_relaxed);
+  struct stat stat_buf;
+  if (fstat(db_fds_[0], &stat_buf) != 0) {
+    return mapped_pages;
+  }
+  // Only whole pages are mapped: touching the mapping past the end of the file would raise SIGBUS. Pages smaller than
+  // the system's are mapped a system page at a time, since mmap offsets must be aligned to it.
+  size_t unit = std::max(page_size_, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+  size_t file_size = std::min(static_cast<size_t>(stat_buf.st_size), MAX_MAPPED_SIZE);
+  size_t file_pages = file_size / unit * unit / page_size_;
+  if (file_pages <= mapped_pages) {
+    return mapped_pages;
+  }
+  size_t offset = mapped_pages * page_size_;
+  void *extension = mmap(mapping_ + offset, (file_pages - mapped_pages) * page_size_, PROT_READ, MAP_SHARED | MAP_FIXED,
+                         db_fds_[0], static_cast<off_t>(offset));
+  if (extension == MAP_FAILED) {
+    LOG_DEBUG("cannot map the db file: %s", strerror(errno));
+    return mapped_pages;
+  }
+  mapped_pages_.store(file_pages, std::memory_order_release);
+  return file_pages;
+}
+
+/**
+ * Start reading the specified page without waiting for it
+ */
+void DiskManager::ReadPageAsync(page_id_t page_id, char *page_data, std::function<void(bool)> callback) {
+  BUSTUB_ASSERT(!direct_io_ || IsAligned(page_data), "direct I/O needs an aligned buffer");
+  size_t file;
+  page_id_t local_page = GetLocalPage(page_id, &file);
+  GetAsyncIO(file)->Submit(DiskRequest{false, local_page, page_data, 1,
+                                       RecordOnCompletion(IOOperation::READ, std::move(callback)), page_size_});
+}
+
+/**
+ * Start writing the specified page without waiting for it
+ */
+void DiskManager::WritePageAsync(page_id_t page_id, const char *page_data, std::function<void(bool)> callback) {
+  BUSTUB_ASSERT(!direct_io_ || IsAligned(page_data), "direct I/O needs an aligned buffer");
+  if (!FlushFreeSpaceMap() && free_space_map_->IsTakenUnflushed(page_id)) {
+    LOG_DEBUG("cannot write page %d before the free space map that handed it out", page_id);
+    if (callback) {
+      callback(false);
+    }
+    return;
+  }
+  num_writes_ += 1;
+  size_t file;
+  page_id_t local_page = GetLocalPage(page_id, &file);
+  // the backend only reads from the data of a write
+  GetAsyncIO(file)->Submit(DiskRequest{true, local_page, const_cast<char *>(page_data), 1,
+                                       RecordOnCompletion(IOOperation::WRITE, std::move(callback)), page_size_});
+}
+
+/**
+ * Wait for all the asynchronous reads and writes in flight
+ */
+void DiskManager::WaitForAsyncIO() {
+  std::lock_guard<std::mutex> guard(async_io_latch_);
+  for (auto &async_io : async_io_) {
+    if (async_io != nullptr) {
+      async_io->Drain();
     }
   }
 }
 
+/**
+ * Wrap the callback of an asynchronous I/O so that the I/O is counted, with the tag of the submitting thread
+ */
+std::function<void(bool)> DiskManager::RecordOnCompletion(IOOperation operation, std::function<void(bool)> callback) {
+  auto start = std::chrono::steady_clock::now();
+  IOTag tag = IOTagScope::Current();
+  return [this, operation, start, tag, callback = std::move(callback)](bool success) {
+    // a failed I/O still took time, but transferred nothing
+    io_stats_.Record(operation, tag, success ? page_size_ : 0, std::chrono::steady_clock::now() - start);
+    if (callback) {
+      callback(success);
+    }
+  };
+}
+
+const char *DiskManager::GetAsyncIOBackendName() { return GetAsyncIO(0)->GetName(); }
+
+AsyncDiskIO *DiskManager::GetAsyncIO(size_t file) {
+  std::lock_guard<std::mutex> guard(async_io_latch_);
+  if (async_io_[file] == nullptr) {
+    async_io_[file] = AsyncDiskIO::Create(db_fds_[file]);
+  }
+  return async_io_[file].get();
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -132,7 +445,10 @@ void DiskManager::WriteLog(char *log_data, int size) {
 
   num_flushes_ += 1;
   // sequence write
+  auto start = std::chrono::steady_clock::now();
   log_io_.write(log_data, size);
+  auto written = std::chrono::steady_clock::now();
+  io_stats_.Record(IOOperation::LOG_WRITE, IOTag::LOG, size, written - start);
 
   // check for I/O error
   if (log_io_.bad()) {
@@ -141,6 +457,7 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
   // needs to flush to keep disk file in sync
   log_io_.flush();
+  io_stats_.Record(IOOperation::SYNC, IOTag::LOG, 0, std::chrono::steady_clock::now() - written);
   flush_log_ = false;
 }
 
@@ -155,10 +472,12 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
     // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
   }
+  auto start = std::chrono::steady_clock::now();
   log_io_.seekp(offset);
   log_io_.read(log_data, size);
   // if log file ends before reading "size"
   int read_count = log_io_.gcount();
+  io_stats_.Record(IOOperation::READ, IOTag::LOG, read_count, std::chrono::steady_clock::now() - start);
   if (read_count < size) {
     log_io_.clear();
     memset(log_data + read_count, 0, size - read_count);
@@ -169,16 +488,55 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
 
 /**
  * Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * Reuse the lowest deallocated page, or grow the file by one page
  */
-page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
+page_id_t DiskManager::AllocatePage() {
+  if (free_space_map_ != nullptr) {
+    if (page_id_t page_id = free_space_map_->Take(); page_id != INVALID_PAGE_ID) {
+      return page_id;
+    }
+  }
+  return next_page_id_++;
+}
+
+/**
+ * Allocate contiguous pages for a table heap or index
+ */
+page_id_t DiskManager::AllocateExtent(size_t num_pages) {
+  BUSTUB_ASSERT(db_fds_.size() == 1 || num_pages <= static_cast<size_t>(STRIPE_SIZE),
+                "a striped extent must fit in one stripe");
+  if (db_fds_.size() <= 1) {
+    return next_page_id_.fetch_add(static_cast<page_id_t>(num_pages));
+  }
+  // Start striped extents on a stripe boundary, so that each one is contiguous in a single file. The pages skipped to
+  // get there are free for AllocatePage.
+  page_id_t skipped = next_page_id_.load();
+  page_id_t first_page;
+  do {
+    first_page = (skipped + STRIPE_SIZE - 1) / STRIPE_SIZE * STRIPE_SIZE;
+  } while (!next_page_id_.compare_exchange_weak(skipped, first_page + static_cast<page_id_t>(num_pages)));
+  for (; skipped < first_page; skipped++) {
+    DeallocatePage(skipped);
+  }
+  return first_page;
+}
 
 /**
  * Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * Record it in the free space map so that it can be reused
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  if (free_space_map_ == nullptr || page_id < 0 || page_id >= next_page_id_.load()) {
+    return;
+  }
+  free_space_map_->Free(page_id);
+}
+
+/**
+ * Write the changes to the free space map before a page is written, so that a page taken from the map is out of it
+ * on disk before its data is in the db file
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+bool DiskManager::FlushFreeSpaceMap() { return free_space_map_ == nullptr || free_space_map_->Flush(); }
 
 /**
  * Returns number of flushes made so far
@@ -195,13 +553,76 @@ int DiskManager::GetNumWrites() const { return num_writes_; }
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to write a buffer at an offset of the db file, retrying short writes
+ */
+bool DiskManager::WriteAt(int fd, const char *data, size_t size, off_t offset) {
+  iovec iov{const_cast<char *>(data), size};
+  return WriteRunAt(fd, &iov, 1, offset);
+}
+
+/**
+ * Private helper function to write a gather list at an offset of the db file, retrying short writes
+ */
+bool DiskManager::WriteRunAt(int fd, iovec *iov, size_t iov_count, off_t offset) {
+  while (iov_count > 0) {
+    ssize_t result = pwritev(fd, iov, static_cast<int>(iov_count), offset);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      return false;
+    }
+    offset += result;
+    // skip what was written, which may end in the middle of a buffer
+    auto written = static_cast<size_t>(result);
+    while (iov_count > 0 && written >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov++;
+      iov_count--;
+    }
+    if (iov_count > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+  return true;
+}
+
+/**
+ * Private helper function to find the file that holds a page: stripes of STRIPE_SIZE pages go to the files in turn
+ */
+page_id_t DiskManager::GetLocalPage(page_id_t page_id, size_t *file) const {
+  size_t num_files = db_fds_.size();
+  // an invalid id keeps its negative offset in the first file, so the read or write of it fails with EINVAL
+  if (num_files <= 1 || page_id < 0) {
+    *file = 0;
+    return page_id;
+  }
+  auto stripe = static_cast<size_t>(page_id) / STRIPE_SIZE;
+  *file = stripe % num_files;
+  return static_cast<page_id_t>(stripe / num_files * STRIPE_SIZE + page_id % STRIPE_SIZE);
+}
+
+/**
+ * Private helper function to find the page id of a page of one of the files, the inverse of GetLocalPage
+ */
+page_id_t DiskManager::GetGlobalPage(size_t file, page_id_t local_page) const {
+  size_t num_files = db_fds_.size();
+  if (num_files <= 1) {
+    return local_page;
+  }
+  auto stripe = static_cast<size_t>(local_page) / STRIPE_SIZE * num_files + file;
+  return static_cast<page_id_t>(stripe * STRIPE_SIZE + local_page % STRIPE_SIZE);
+}
+
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
 }
 
 }  // namespace bustub
@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory.cpp
+//
+// Identification: src/storage/disk/disk_manager_memory.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_memory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>  // NOLINT
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+/** Waits shorter than this are spun rather than slept, since a sleep may oversleep by about as much. */
+constexpr std::chrono::microseconds SPIN_THRESHOLD{100};
+
+void WaitUntil(std::chrono::steady_clock::time_point deadline) {
+  auto now = std::chrono::steady_clock::now();
+  if (deadline - now > SPIN_THRESHOLD) {
+    std::this_thread::sleep_until(deadline - SPIN_THRESHOLD);
+  }
+  while (std::chrono::steady_clock::now() < deadline) {
+  }
+}
+
+}  // namespace
+
+DiskManagerMemory::~DiskManagerMemory() {
+  WaitForAsyncIO();
+  {
+    std::lock_guard<std::mutex> guard(async_latch_);
+    async_stopped_ = true;
+  }
+  async_cv_.notify_all();
+  if (async_worker_.joinable()) {
+    async_worker_.join();
+  }
+}
+
+void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
+  auto start = std::chrono::steady_clock::now();
+  Simulate(disk_.write_latency_, page_size_);
+  num_writes_ += 1;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    memcpy(GetPage(page_id), page_data, page_size_);
+  }
+  io_stats_.Record(IOOperation::WRITE, IOTagScope::Current(), page_size_, std::chrono::steady_clock::now() - start);
+}
+
+std::vector<page_id_t> DiskManagerMemory::WritePages(std::vector<std::pair<page_id_t, const char *>> *pages) {
+  if (pages->empty()) {
+    return {};
+  }
+  std::sort(pages->begin(), pages->end());
+  auto start = std::chrono::steady_clock::now();
+  Simulate(disk_.write_latency_, pages->size() * page_size_);
+  num_writes_ += pages->size();
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    for (const auto &[page_id, page_data] : *pages) {
+      memcpy(GetPage(page_id), page_data, page_size_);
+    }
+  }
+  io_stats_.Record(IOOperation::WRITE, IOTagScope::Current(), pages->size() * page_size_,
+                   std::chrono::steady_clock::now() - start);
+  return {};
+}
+
+void DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) {
+  auto start = std::chrono::steady_clock::now();
+  Simulate(disk_.read_latency_, page_size_);
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (page_id < 0 || static_cast<size_t>(page_id) >= pages_.size() || pages_[page_id] == nullptr) {
+      // Like reading past the end of a file.
+      memset(page_data, 0, page_size_);
+    } else {
+      memcpy(page_data, pages_[page_id].get(), page_size_);
+    }
+  }
+  io_stats_.Record(IOOperation::READ, IOTagScope::Current(), page_size_, std::chrono::steady_clock::now() - start);
+}
+
+void DiskManagerMemory::ReadPageAsync(page_id_t page_id, char *page_data, std::function<void(bool)> callback) {
+  SubmitAsync([this, page_id, page_data, callback = std::move(callback), tag = IOTagScope::Current()] {
+    IOTagScope scope(tag);
+    ReadPage(page_id, page_data);
+    if (callback) {
+      callback(true);
+    }
+  });
+}
+
+void DiskManagerMemory::WritePageAsync(page_id_t page_id, const char *page_data, std::function<void(bool)> callback) {
+  SubmitAsync([this, page_id, page_data, callback = std::move(callback), tag = IOTagScope::Current()] {
+    IOTagScope scope(tag);
+    WritePage(page_id, page_data);
+    if (callback) {
+      callback(true);
+    }
+  });
+}
+
+void DiskManagerMemory::WaitForAsyncIO() {
+  std::unique_lock<std::mutex> lock(async_latch_);
+  async_cv_.wait(lock, [this] { return async_in_flight_ == 0; });
+}
+
+void DiskManagerMemory::SubmitAsync(std::function<void()> request) {
+  {
+    std::lock_guard<std::mutex> guard(async_latch_);
+    if (!async_worker_.joinable()) {
+      async_worker_ = std::thread([this] { WorkAsync(); });
+    }
+    async_queue_.push_back(std::move(request));
+    async_in_flight_++;
+  }
+  async_cv_.notify_all();
+}
+
+void DiskManagerMemory::WorkAsync() {
+  std::unique_lock<std::mutex> lock(async_latch_);
+  while (true) {
+    async_cv_.wait(lock, [this] { return async_stopped_ || !async_queue_.empty(); });
+    if (async_queue_.empty()) {
+      return;
+    }
+    std::function<void()> request = std::move(async_queue_.front());
+    async_queue_.pop_front();
+    lock.unlock();
+    request();
+    lock.lock();
+    if (--async_in_flight_ == 0) {
+      async_cv_.notify_all();
+    }
+  }
+}
+
+void DiskManagerMemory::WriteLog(char *log_data, int size) {
+  if (size == 0) {
+    return;
+  }
+  flush_log_ = true;
+  auto start = std::chrono::steady_clock::now();
+  Simulate(disk_.write_latency_, size);
+  {
+    std::lock_guard<std::mutex> guard(log_latch_);
+    num_flushes_ += 1;
+    log_.insert(log_.end(), log_data, log_data + size);
+  }
+  io_stats_.Record(IOOperation::LOG_WRITE, IOTag::LOG, size, std::chrono::steady_clock::now() - start);
+  flush_log_ = false;
+}
+
+bool DiskManagerMemory::ReadLog(char *log_data, int size, int offset) {
+  auto start = std::chrono::steady_clock::now();
+  Simulate(disk_.read_latency_, size);
+  size_t read_count;
+  {
+    std::lock_guard<std::mutex> guard(log_latch_);
+    if (offset < 0 || static_cast<size_t>(offset) >= log_.size()) {
+      return false;
+    }
+    read_count = std::min(static_cast<size_t>(size), log_.size() - offset);
+    memcpy(log_data, log_.data() + offset, read_count);
+    memset(log_data + read_count, 0, size - read_count);
+  }
+  io_stats_.Record(IOOperation::READ, IOTag::LOG, read_count, std::chrono::steady_clock::now() - start);
+  return true;
+}
+
+void DiskManagerMemory::Simulate(std::chrono::nanoseconds latency, size_t bytes) {
+  if (latency.count() == 0 && disk_.bandwidth_ == 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  auto done = now;
+  if (disk_.bandwidth_ != 0) {
+    auto transfer = std::chrono::nanoseconds(static_cast<int64_t>(bytes * 1e9 / disk_.bandwidth_));
+    std::lock_guard<std::mutex> guard(device_latch_);
+    // The transfer starts once the device is done with the ones queued before it.
+    device_free_at_ = std::max(now, device_free_at_) + transfer;
+    done = device_free_at_;
+  }
+  done += latency;
+  simulated_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(done - now).count();
+  WaitUntil(done);
+}
+
+char *DiskManagerMemory::GetPage(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id >= 0, "cannot write an invalid page");
+  if (static_cast<size_t>(page_id) >= pages_.size()) {
+    pages_.resize(page_id + 1);
+  }
+  if (pages_[page_id] == nullptr) {
+    pages_[page_id] = std::make_unique<char[]>(page_size_);
+  }
+  return pages_[page_id].get();
+}
+
+}  // namespace bustub
@@ -0,0 +1,203 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/disk/free_space_map.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_space_map.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(std::string file_name, page_id_t num_pages) : file_name_(std::move(file_name)) {
+  fd_ = open(file_name_.c_str(), O_RDWR);
+  if (fd_ < 0) {
+    return;
+  }
+  off_t size = lseek(fd_, 0, SEEK_END);
+  size_t num_map_pages = size > 0 ? (size + PAGE_SIZE - 1) / PAGE_SIZE : 0;
+  words_.resize(num_map_pages * WORDS_PER_MAP_PAGE);
+  size_t read_count = 0;
+  auto *data = reinterpret_cast<char *>(words_.data());
+  while (read_count < static_cast<size_t>(size)) {
+    ssize_t result = pread(fd_, data + read_count, size - read_count, read_count);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    read_count += result;
+  }
+
+  size_t num_free = 0;
+  bool dropped = false;
+  for (size_t word = 0; word < words_.size(); word++) {
+    // Pages past the end of the database file are not free, they do not exist yet.
+    for (size_t bit = 0; bit < 64 && words_[word] != 0; bit++) {
+      if ((words_[word] >> bit & 1) != 0 && word * 64 + bit >= static_cast<size_t>(num_pages)) {
+        words_[word] &= ~(uint64_t{1} << bit);
+        dropped = true;
+      }
+    }
+    num_free += __builtin_popcountll(words_[word]);
+  }
+  num_free_.store(num_free, std::memory_order_relaxed);
+  if (dropped) {
+    for (size_t word = 0; word < words_.size(); word += WORDS_PER_MAP_PAGE) {
+      MarkDirty(word);
+    }
+  }
+}
+
+FreeSpaceMap::~FreeSpaceMap() { Close(); }
+
+page_id_t FreeSpaceMap::Take() {
+  if (num_free_.load(std::memory_order_relaxed) == 0) {
+    return INVALID_PAGE_ID;
+  }
+  std::lock_guard<std::mutex> guard(latch_);
+  for (size_t word = first_free_word_; word < words_.size(); word++) {
+    if (words_[word] == 0) {
+      continue;
+    }
+    int bit = __builtin_ctzll(words_[word]);
+    words_[word] &= ~(uint64_t{1} << bit);
+    first_free_word_ = word;
+    num_free_.fetch_sub(1, std::memory_order_relaxed);
+    MarkDirty(word);
+    auto page_id = static_cast<page_id_t>(word * 64 + bit);
+    unflushed_takes_.push_back(page_id);
+    return page_id;
+  }
+  first_free_word_ = words_.size();
+  return INVALID_PAGE_ID;
+}
+
+void FreeSpaceMap::Free(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id >= 0, "cannot free an invalid page");
+  std::lock_guard<std::mutex> guard(latch_);
+  size_t word = page_id / 64;
+  uint64_t mask = uint64_t{1} << (page_id % 64);
+  if (word >= words_.size()) {
+    words_.resize((word / WORDS_PER_MAP_PAGE + 1) * WORDS_PER_MAP_PAGE);
+  }
+  if ((words_[word] & mask) != 0) {
+    return;
+  }
+  words_[word] |= mask;
+  first_free_word_ = std::min(first_free_word_, word);
+  num_free_.fetch_add(1, std::memory_order_relaxed);
+  MarkDirty(word);
+}
+
+bool FreeSpaceMap::IsFree(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  size_t word = page_id / 64;
+  return word < words_.size() && (words_[word] >> (page_id % 64) & 1) != 0;
+}
+
+bool FreeSpaceMap::Flush() {
+  if (!dirty_.load(std::memory_order_acquire)) {
+    return true;
+  }
+  std::lock_guard<std::mutex> guard(latch_);
+  return FlushDirty();
+}
+
+bool FreeSpaceMap::IsTakenUnflushed(page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  return std::find(unflushed_takes_.begin(), unflushed_takes_.end(), page_id) != unflushed_takes_.end();
+}
+
+void FreeSpaceMap::Close() {
+  std::lock_guard<std::mutex> guard(latch_);
+  FlushDirty();
+  closed_ = true;
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+void FreeSpaceMap::MarkDirty(size_t word) {
+  size_t map_page = word / WORDS_PER_MAP_PAGE;
+  if (map_page >= dirty_map_pages_.size()) {
+    dirty_map_pages_.resize(words_.size() / WORDS_PER_MAP_PAGE);
+  }
+  dirty_map_pages_[map_page] = true;
+  dirty_.store(true, std::memory_order_release);
+}
+
+bool FreeSpaceMap::FlushDirty() {
+  if (closed_ || !dirty_.load(std::memory_order_relaxed)) {
+    return !dirty_.load(std::memory_order_relaxed);
+  }
+  bool flushed = true;
+  std::vector<size_t> written;
+  for (size_t map_page = 0; map_page < dirty_map_pages_.size(); map_page++) {
+    if (dirty_map_pages_[map_page]) {
+      // A map page that could not be written stays dirty, so that the next flush tries again.
+      dirty_map_pages_[map_page] = !Persist(map_page);
+      if (dirty_map_pages_[map_page]) {
+        flushed = false;
+      } else {
+        written.push_back(map_page);
+      }
+    }
+  }
+  if (!written.empty() && fdatasync(fd_) != 0) {
+    LOG_WARN("cannot sync free space map %s: %s", file_name_.c_str(), strerror(errno));
+    // What was written may not be on disk, so it is written again by the next flush.
+    for (size_t map_page : written) {
+      dirty_map_pages_[map_page] = true;
+    }
+    flushed = false;
+  }
+  if (flushed) {
+    unflushed_takes_.clear();
+  }
+  dirty_.store(!flushed, std::memory_order_release);
+  return flushed;
+}
+
+bool FreeSpaceMap::Persist(size_t map_page) {
+  if (fd_ < 0) {
+    fd_ = open(file_name_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+      LOG_WARN("cannot create free space map %s: %s", file_name_.c_str(), strerror(errno));
+      return false;
+    }
+  }
+  const auto *data = reinterpret_cast<const char *>(words_.data() + map_page * WORDS_PER_MAP_PAGE);
+  size_t written = 0;
+  while (written < PAGE_SIZE) {
+    ssize_t result = pwrite(fd_, data + written, PAGE_SIZE - written, map_page * PAGE_SIZE + written);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      LOG_DEBUG("I/O error while writing the free space map: %s", strerror(errno));
+      return false;
+    }
+    written += result;
+  }
+  return true;
+}
+
+}  // namespace bustub
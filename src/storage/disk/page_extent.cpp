@@ -0,0 +1,28 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_extent.cpp
+//
+// Identification: src/storage/disk/page_extent.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_extent.h"
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+page_id_t PageExtent::AllocatePage(DiskManager *disk_manager) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (next_ == end_) {
+    next_ = disk_manager->AllocateExtent(extent_size_);
+    end_ = next_ + static_cast<page_id_t>(extent_size_);
+  }
+  return next_++;
+}
+
+}  // namespace bustub
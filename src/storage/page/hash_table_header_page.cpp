@@ -13,7 +13,7 @@
 #include "storage/page/hash_table_header_page.h"
 
 namespace bustub {
-page_id_t HashTableHeaderPage::GetBlockPageId(size_t index) { return 0; }
+page_id_t HashTableHeaderPage::GetBlockPageId(size_t index) const { return 0; }
 
 page_id_t HashTableHeaderPage::GetPageId() const { return 0; }
 
@@ -25,7 +25,7 @@ void HashTableHeaderPage::SetLSN(lsn_t lsn) {}
 
 void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {}
 
-size_t HashTableHeaderPage::NumBlocks() { return 0; }
+size_t HashTableHeaderPage::NumBlocks() const { return 0; }
 
 void HashTableHeaderPage::SetSize(size_t size) {}
 
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.cpp
+//
+// Identification: src/storage/page/page_guard.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/page_guard.h"
+
+#include <utility>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
+    : bpm_(that.bpm_), page_(that.page_), is_dirty_(that.is_dirty_) {
+  that.bpm_ = nullptr;
+  that.page_ = nullptr;
+  that.is_dirty_ = false;
+}
+
+BasicPageGuard &BasicPageGuard::operator=(BasicPageGuard &&that) noexcept {
+  if (this != &that) {
+    Drop();
+    bpm_ = that.bpm_;
+    page_ = that.page_;
+    is_dirty_ = that.is_dirty_;
+    that.bpm_ = nullptr;
+    that.page_ = nullptr;
+    that.is_dirty_ = false;
+  }
+  return *this;
+}
+
+void BasicPageGuard::Drop() {
+  if (page_ != nullptr) {
+    bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
+  }
+  bpm_ = nullptr;
+  page_ = nullptr;
+  is_dirty_ = false;
+}
+
+ReadPageGuard BasicPageGuard::UpgradeRead() {
+  if (page_ != nullptr) {
+    page_->RLatch();
+  }
+  ReadPageGuard guard;
+  guard.guard_ = std::move(*this);
+  return guard;
+}
+
+WritePageGuard BasicPageGuard::UpgradeWrite() {
+  if (page_ != nullptr) {
+    page_->WLatch();
+  }
+  WritePageGuard guard;
+  guard.guard_ = std::move(*this);
+  return guard;
+}
+
+ReadPageGuard &ReadPageGuard::operator=(ReadPageGuard &&that) noexcept {
+  if (this != &that) {
+    Drop();
+    guard_ = std::move(that.guard_);
+  }
+  return *this;
+}
+
+void ReadPageGuard::Drop() {
+  if (guard_.page_ != nullptr) {
+    guard_.page_->RUnlatch();
+  }
+  guard_.Drop();
+}
+
+WritePageGuard &WritePageGuard::operator=(WritePageGuard &&that) noexcept {
+  if (this != &that) {
+    Drop();
+    guard_ = std::move(that.guard_);
+  }
+  return *this;
+}
+
+void WritePageGuard::Drop() {
+  if (guard_.page_ != nullptr) {
+    guard_.page_->WUnlatch();
+  }
+  guard_.Drop();
+}
+
+}  // namespace bustub
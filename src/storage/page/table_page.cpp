@@ -264,7 +264,7 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
   }
 }
 
-bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
+bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) const {
   // Get the current slot number.
   uint32_t slot_num = rid.GetSlotNum();
   // If somehow we have more slots than tuples, abort the transaction.
@@ -304,7 +304,35 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   return true;
 }
 
-bool TablePage::GetFirstTupleRid(RID *first_rid) {
+bool TablePage::GetTupleOptimistic(const RID &rid, Tuple *tuple) const {
+  // A writer may be changing the page, so every field is loaded atomically and checked against the page bounds before
+  // it is used to read further.
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= LoadOptimistic<uint32_t>(GetData() + OFFSET_TUPLE_COUNT) ||
+      OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num + sizeof(uint32_t) > GetPageSize()) {
+    return false;
+  }
+  auto tuple_size = LoadOptimistic<uint32_t>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num);
+  auto tuple_offset = LoadOptimistic<uint32_t>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
+  if (IsDeleted(tuple_size) || tuple_offset > GetPageSize() || tuple_size > GetPageSize() - tuple_offset) {
+    return false;
+  }
+
+  // The reader may run again, so the tuple keeps its buffer if it already has the right size.
+  if (!tuple->allocated_ || tuple->size_ != tuple_size) {
+    if (tuple->allocated_) {
+      delete[] tuple->data_;
+    }
+    tuple->data_ = new char[tuple_size];
+    tuple->size_ = tuple_size;
+    tuple->allocated_ = true;
+  }
+  CopyOptimistic(tuple->data_, GetData() + tuple_offset, tuple_size);
+  tuple->rid_ = rid;
+  return true;
+}
+
+bool TablePage::GetFirstTupleRid(RID *first_rid) const {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
     if (GetTupleSize(i) > 0) {
@@ -316,7 +344,7 @@ bool TablePage::GetFirstTupleRid(RID *first_rid) {
   return false;
 }
 
-bool TablePage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) {
+bool TablePage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) const {
   BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
   for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); ++i) {
@@ -11,8 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <memory>
+#include <utility>
 
 #include "common/logger.h"
+#include "storage/disk/disk_io_stats.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -27,17 +30,19 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
     : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
+  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPageInExtent(&first_page_id_, &extent_));
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
   first_page->WLatch();
-  first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  first_page->Init(first_page_id_, buffer_pool_manager_->GetPageSize(), INVALID_LSN, log_manager_, txn);
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
-  if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
+  if (tuple.size_ + 32 > buffer_pool_manager_->GetPageSize()) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
@@ -63,7 +68,7 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       cur_page->WLatch();
     } else {
       // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPageInExtent(&next_page_id, &extent_));
       // If we could not create a new page,
       if (new_page == nullptr) {
         // Then life sucks and we abort the transaction.
@@ -75,7 +80,7 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       // Otherwise we were able to create a new page. We initialize it now.
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      new_page->Init(next_page_id, buffer_pool_manager_->GetPageSize(), cur_page->GetTablePageId(), log_manager_, txn);
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -91,38 +96,39 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
 }
 
 bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Otherwise, mark the tuple as deleted.
-  page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  guard.AsMut<TablePage>()->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  guard.Drop();
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
   return true;
 }
 
 bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) {
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
-  page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  bool is_updated = guard.As<TablePage>()->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  if (is_updated) {
+    guard.SetDirty();
+  }
+  guard.Drop();
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
@@ -131,54 +137,74 @@ bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
 }
 
 void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard, "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
-  page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  guard.AsMut<TablePage>()->ApplyDelete(rid, txn, log_manager_);
   lock_manager_->Unlock(txn, rid);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard, "Couldn't find a page containing that RID.");
   // Rollback the delete.
-  page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  guard.AsMut<TablePage>()->RollbackDelete(rid, txn, log_manager_);
 }
 
 bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
   // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
-  // Read the tuple from the page.
-  page->RLatch();
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
-  page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
-  return res;
+  // With logging on, the read takes a shared lock on the tuple, which an optimistic reader cannot do.
+  if (enable_logging) {
+    ReadPageGuard read_guard = guard.UpgradeRead();
+    return read_guard.As<TablePage>()->GetTuple(rid, tuple, txn, lock_manager_);
+  }
+  // Otherwise read the tuple without the page latch, so that point reads of a hot page do not contend on it.
+  bool is_read = false;
+  guard.ReadOptimistic<TablePage>([&](const TablePage *page) { is_read = page->GetTupleOptimistic(rid, tuple); });
+  return is_read;
 }
 
-TableIterator TableHeap::Begin(Transaction *txn) {
+TableIterator TableHeap::Begin(Transaction *txn, BufferAccessStrategy *strategy) {
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
   // Start an iterator from the first page.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPageWithStrategy(first_page_id_, strategy));
   page->RLatch();
   RID rid;
   // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
   page->GetFirstTupleRid(&rid);
+  auto read_ahead = ReadAhead(page->GetNextPageId(), READ_AHEAD_PAGES);
   page->RUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, false);
-  return TableIterator(this, rid, txn);
+  return TableIterator(this, rid, txn, strategy, std::move(read_ahead));
+}
+
+std::shared_ptr<ReadAheadWindow> TableHeap::ReadAhead(page_id_t page_id, size_t num_pages) {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  auto window = std::make_shared<ReadAheadWindow>(page_id, num_pages);
+  buffer_pool_manager_->PrefetchPage(page_id, num_pages, [window](Page *page) {
+    page->RLatch();
+    page_id_t next_page_id = static_cast<TablePage *>(page)->GetNextPageId();
+    page->RUnlatch();
+    if (next_page_id != INVALID_PAGE_ID) {
+      window->last_page_id_.store(next_page_id, std::memory_order_relaxed);
+      window->known_pages_.fetch_add(1, std::memory_order_release);
+    }
+    return next_page_id;
+  });
+  return window;
 }
 
 TableIterator TableHeap::End() { return TableIterator(this, RID(INVALID_PAGE_ID, 0), nullptr); }
@@ -11,13 +11,21 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <utility>
 
+#include "storage/disk/disk_io_stats.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferAccessStrategy *strategy,
+                             std::shared_ptr<ReadAheadWindow> read_ahead)
+    : table_heap_(table_heap),
+      tuple_(new Tuple(rid)),
+      txn_(txn),
+      strategy_(strategy),
+      read_ahead_pages_(read_ahead == nullptr ? 0 : read_ahead->num_pages_),
+      read_ahead_(std::move(read_ahead)) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
     table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
   }
@@ -34,8 +42,10 @@ Tuple *TableIterator::operator->() {
 }
 
 TableIterator &TableIterator::operator++() {
+  IOTagScope io_tag(IOTag::TABLE_HEAP);
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
+  auto cur_page =
+      static_cast<TablePage *>(buffer_pool_manager->FetchPageWithStrategy(tuple_->rid_.GetPageId(), strategy_));
   cur_page->RLatch();
   assert(cur_page != nullptr);  // all pages are pinned
 
@@ -43,11 +53,29 @@ TableIterator &TableIterator::operator++() {
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      auto next_page =
+          static_cast<TablePage *>(buffer_pool_manager->FetchPageWithStrategy(cur_page->GetNextPageId(), strategy_));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
+      // Keep the background reads a few pages ahead of us. Once half of the window already queued is used up, the
+      // next one continues the chain from the last page queued, so the prefetcher always has pages left to read while
+      // the scan catches up, and no page is queued twice.
+      if (read_ahead_pages_ > 0) {
+        read_ahead_pages_--;
+      }
+      if (read_ahead_ != nullptr && read_ahead_->IsComplete() &&
+          read_ahead_pages_ <= static_cast<size_t>(READ_AHEAD_PAGES) / 2) {
+        // The last page is requested again only to follow its link; it has been read already, so that costs no I/O.
+        size_t num_pages = READ_AHEAD_PAGES - read_ahead_pages_;
+        read_ahead_ = table_heap_->ReadAhead(read_ahead_->last_page_id_.load(), num_pages + 1);
+        read_ahead_pages_ = READ_AHEAD_PAGES;
+      } else if (read_ahead_pages_ == 0) {
+        // The prefetcher has not got to the end of the last window, or dropped it, so start afresh from here.
+        read_ahead_ = table_heap_->ReadAhead(cur_page->GetNextPageId(), READ_AHEAD_PAGES);
+        read_ahead_pages_ = READ_AHEAD_PAGES;
+      }
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
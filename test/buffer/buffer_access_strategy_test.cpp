@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy_test.cpp
+//
+// Identification: test/buffer/buffer_access_strategy_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BufferAccessStrategyTest, SampleTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 10;
+  const page_id_t num_pages = 30;
+  const page_id_t num_hot_pages = 6;
+
+  auto *disk_manager = new DiskManager(db_name);
+
+  // Put some pages on disk.
+  {
+    BufferPoolManagerInstance bpm(buffer_pool_size, disk_manager);
+    for (page_id_t i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      Page *page = bpm.NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+      EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+    }
+    bpm.FlushAllPages();
+  }
+
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: a few hot pages are modified and left in the pool.
+  for (page_id_t page_id = 0; page_id < num_hot_pages; page_id++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  int writes = disk_manager->GetNumWrites();
+
+  // Scenario: a scan through a ring of 3 frames reads every other page without evicting any hot page.
+  BufferAccessStrategy strategy(bpm, 3);
+  for (page_id_t page_id = num_hot_pages; page_id < num_pages; page_id++) {
+    Page *page = bpm->FetchPageWithStrategy(page_id, &strategy);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(num_pages - num_hot_pages - 3, strategy.GetNumReleased());
+  EXPECT_EQ(writes, disk_manager->GetNumWrites());
+
+  // Scenario: a pinned page is never released.
+  EXPECT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_FALSE(bpm->ReleasePage(0));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->ReleasePage(0));
+  EXPECT_FALSE(bpm->ReleasePage(0));
+  EXPECT_EQ(writes + 1, disk_manager->GetNumWrites());
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -10,21 +10,31 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
+#include "storage/db_files.h"
+#include "storage/disk/page_extent.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
+TEST(BufferPoolManagerTest, SampleTest) {
   const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
   const size_t buffer_pool_size = 10;
 
   auto *disk_manager = new DiskManager(db_name);
-  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
 
   page_id_t page_id_temp;
   auto *page0 = bpm->NewPage(&page_id_temp);
@@ -47,6 +57,12 @@ TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
     EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
   }
 
+  // Scenario: a failed creation hands back no page id, so that the caller cannot use one that was given up.
+  PageExtent extent(4);
+  EXPECT_EQ(INVALID_PAGE_ID, page_id_temp);
+  EXPECT_EQ(nullptr, bpm->NewPageInExtent(&page_id_temp, &extent));
+  EXPECT_EQ(INVALID_PAGE_ID, page_id_temp);
+
   // Scenario: After unpinning pages {0, 1, 2, 3, 4} and pinning another 4 new pages,
   // there would still be one buffer page left for reading page 0.
   for (int i = 0; i < 5; ++i) {
@@ -68,10 +84,261 @@ TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
 
   // Shutdown the disk manager and remove the temporary file we created.
   disk_manager->ShutDown();
-  remove("test.db");
+  RemoveDbFiles("test.db");
 
   delete bpm;
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 4;
+  const size_t max_pool_size = 8;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::CLOCK,
+                                            LRUK_REPLACER_K, FrameArena::NO_NUMA_NODE, max_pool_size);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+  EXPECT_EQ(max_pool_size, bpm->GetMaxPoolSize());
+
+  // Scenario: a full pool makes room for more pinned pages once it grows.
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->Resize(max_pool_size));
+  EXPECT_EQ(max_pool_size, bpm->GetPoolSize());
+  for (size_t i = buffer_pool_size; i < max_pool_size; i++) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  // Scenario: the pool cannot grow beyond its maximum, shrink to nothing, or shrink away pinned pages.
+  EXPECT_FALSE(bpm->Resize(max_pool_size + 1));
+  EXPECT_FALSE(bpm->Resize(0));
+  EXPECT_FALSE(bpm->Resize(2));
+  EXPECT_EQ(max_pool_size, bpm->GetPoolSize());
+
+  // Scenario: shrinking evicts the unpinned pages of the retired frames, writing back the dirty ones.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(max_pool_size); i++) {
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+  int writes = disk_manager->GetNumWrites();
+  EXPECT_TRUE(bpm->Resize(2));
+  EXPECT_EQ(2, bpm->GetPoolSize());
+  EXPECT_EQ(writes + 6, disk_manager->GetNumWrites());
+
+  // Scenario: the evicted pages can be read back, but only two at a time.
+  Page *page5 = bpm->FetchPage(5);
+  ASSERT_NE(nullptr, page5);
+  EXPECT_STREQ("page 5", page5->GetData());
+  Page *page6 = bpm->FetchPage(6);
+  ASSERT_NE(nullptr, page6);
+  EXPECT_STREQ("page 6", page6->GetData());
+  EXPECT_EQ(nullptr, bpm->FetchPage(7));
+  EXPECT_TRUE(bpm->UnpinPage(5, false));
+  EXPECT_TRUE(bpm->UnpinPage(6, false));
+
+  // Scenario: growing again reuses the retired frames, which come back zeroed.
+  EXPECT_TRUE(bpm->Resize(max_pool_size));
+  for (size_t i = 2; i < max_pool_size; i++) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetData()[0]);
+  }
+  for (page_id_t i = 0; i < static_cast<page_id_t>(max_pool_size); i++) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+  }
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentUnpinTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 4;
+  const int num_threads = 4;
+  const int num_rounds = 5000;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: threads keep pinning and unpinning the same resident pages; only one of them dirties them.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < num_rounds; i++) {
+        auto page_id = static_cast<page_id_t>(i % buffer_pool_size);
+        ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+        ASSERT_TRUE(bpm->UnpinPage(page_id, t == 0));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Scenario: every pin was given back, no dirty flag was lost, and an extra unpin is refused.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+    EXPECT_TRUE(bpm->GetPages()[i].IsDirty());
+    EXPECT_FALSE(bpm->UnpinPage(static_cast<page_id_t>(i), false));
+  }
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FlushLatchedPageTest) {
+  RemoveDbFiles("test.db");
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager);
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+
+  // Scenario: a flush waits for the writer of a pinned page, rather than writing it half changed.
+  page->WLatch();
+  memset(page->GetData(), 'a', PAGE_SIZE / 2);
+  std::thread flusher([&] { bpm->FlushAllPages(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  memset(page->GetData(), 'b', PAGE_SIZE);
+  page->WUnlatch();
+  flusher.join();
+  char buf[PAGE_SIZE];
+  disk_manager->ReadPage(page_id, buf);
+  EXPECT_EQ('b', buf[0]);
+  EXPECT_EQ('b', buf[PAGE_SIZE - 1]);
+
+  // Scenario: the flush gave its pin back, and the writer's pin is still there.
+  EXPECT_EQ(1, page->GetPinCount());
+
+  // Scenario: so does a flush of that one page.
+  page->WLatch();
+  memset(page->GetData(), 'c', PAGE_SIZE / 2);
+  std::thread page_flusher([&] { EXPECT_TRUE(bpm->FlushPage(page_id)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  memset(page->GetData(), 'd', PAGE_SIZE);
+  page->WUnlatch();
+  page_flusher.join();
+  disk_manager->ReadPage(page_id, buf);
+  EXPECT_EQ('d', buf[0]);
+  EXPECT_EQ('d', buf[PAGE_SIZE - 1]);
+  EXPECT_EQ(1, page->GetPinCount());
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FlushFailedPagesTest) {
+  // The second file of the tablespace cannot be opened, so the pages of its stripes cannot be written.
+  ASSERT_EQ(0, mkdir("test_stripe1.db", 0755));
+  RemoveDbFiles("test.db");
+  auto *disk_manager = new DiskManager(std::vector<std::string>{"test.db", "test_stripe1.db"});
+  const page_id_t num_pages = 3 * STRIPE_SIZE;
+  auto *bpm = new BufferPoolManagerInstance(num_pages, disk_manager);
+  std::vector<page_id_t> page_ids(num_pages);
+  for (page_id_t &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: the pages whose writes failed stay dirty, and only those.
+  bpm->FlushAllPages();
+  for (page_id_t page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id / STRIPE_SIZE % 2 == 1, page->IsDirty()) << "page " << page_id;
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  delete bpm;
+  delete disk_manager;
+  RemoveDbFiles("test.db");
+  rmdir("test_stripe1.db");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PageSizeTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t table_page_size = 32 * 1024;
+  const size_t index_page_size = PAGE_SIZE;
+
+  // Scenario: each file has a pool of frames of its own page size.
+  RemoveDbFiles("test_table.db");
+  auto *table_disk_manager = new DiskManager("test_table.db", false, table_page_size);
+  RemoveDbFiles("test_index.db");
+  auto *index_disk_manager = new DiskManager("test_index.db", false, index_page_size);
+  auto *table_bpm = new BufferPoolManagerInstance(buffer_pool_size, table_disk_manager);
+  auto *index_bpm = new BufferPoolManagerInstance(buffer_pool_size, index_disk_manager);
+  EXPECT_EQ(table_page_size, table_bpm->GetPageSize());
+  EXPECT_EQ(index_page_size, index_bpm->GetPageSize());
+
+  // Scenario: whole pages survive being evicted and read back, in both pools.
+  for (auto *bpm : {table_bpm, index_bpm}) {
+    size_t page_size = bpm->GetPageSize();
+    page_id_t page_id;
+    for (size_t i = 0; i < buffer_pool_size * 3; i++) {
+      Page *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(page_size, page->GetPageSize());
+      EXPECT_EQ(0, page->GetData()[page_size - 1]);
+      memset(page->GetData(), static_cast<int>('a' + i), page_size);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size * 3); i++) {
+      Page *page = bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(static_cast<char>('a' + i), page->GetData()[0]);
+      EXPECT_EQ(static_cast<char>('a' + i), page->GetData()[page_size - 1]);
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+    }
+  }
+
+  // Scenario: the compressed tier keeps large pages whole too.
+  table_bpm->SetCompressedTierCapacity(table_page_size * buffer_pool_size);
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size * 3); i++) {
+    Page *page = table_bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(static_cast<char>('a' + i), page->GetData()[table_page_size - 1]);
+    EXPECT_TRUE(table_bpm->UnpinPage(i, false));
+  }
+  EXPECT_GT(table_bpm->GetStats().compressed_hits_, 0);
+
+  table_disk_manager->ShutDown();
+  index_disk_manager->ShutDown();
+  delete table_bpm;
+  delete index_bpm;
+  delete table_disk_manager;
+  delete index_disk_manager;
+  RemoveDbFiles("test_table.db");
+  RemoveDbFiles("test_index.db");
+}
+
 }  // namespace bustub
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats_test.cpp
+//
+// Identification: test/buffer/buffer_pool_stats_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BufferPoolStatsTest, SampleTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(1, disk_manager);
+
+  // Scenario: fetching a resident page is a hit.
+  page_id_t page_id0;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id0));
+  EXPECT_TRUE(bpm->UnpinPage(page_id0, true));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_id0));
+  EXPECT_TRUE(bpm->UnpinPage(page_id0, false));
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(0, stats.misses_);
+  EXPECT_EQ(0, stats.evictions_);
+
+  // Scenario: a new page evicts the dirty page, which has to be written back first.
+  page_id_t page_id1;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id1));
+  EXPECT_TRUE(bpm->UnpinPage(page_id1, false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.evictions_);
+  EXPECT_EQ(1, stats.dirty_evictions_);
+  EXPECT_EQ(1, stats.page_writes_);
+
+  // Scenario: fetching the evicted page is a miss, and evicts the clean page without writing it.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_id0));
+  EXPECT_TRUE(bpm->UnpinPage(page_id0, false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(1, stats.misses_);
+  EXPECT_EQ(2, stats.evictions_);
+  EXPECT_EQ(1, stats.dirty_evictions_);
+  EXPECT_EQ(1, stats.page_writes_);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRate());
+
+  // Scenario: no heat is recorded until sampling is turned on.
+  EXPECT_TRUE(bpm->GetHottestPages(10).empty());
+
+  // Scenario: reset clears every counter.
+  bpm->ResetStats();
+  stats = bpm->GetStats();
+  EXPECT_EQ(0, stats.hits_ + stats.misses_ + stats.evictions_ + stats.page_writes_ + stats.slow_path_ns_);
+
+  delete bpm;
+  delete disk_manager;
+  RemoveDbFiles("test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolStatsTest, HeatTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 4;
+  const size_t num_instances = 2;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  bpm->SetHeatSampleRate(1);
+
+  // Scenario: page i is fetched i + 1 times, spread over both instances.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 4; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    page_ids.push_back(page_id);
+  }
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j <= i; j++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+      EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    }
+  }
+
+  // Scenario: the counters and the heat of both instances are merged.
+  EXPECT_EQ(10, bpm->GetStats().hits_);
+  auto hottest = bpm->GetHottestPages(3);
+  ASSERT_EQ(3, hottest.size());
+  EXPECT_EQ(std::make_pair(page_ids[3], uint64_t{4}), hottest[0]);
+  EXPECT_EQ(std::make_pair(page_ids[2], uint64_t{3}), hottest[1]);
+  EXPECT_EQ(std::make_pair(page_ids[1], uint64_t{2}), hottest[2]);
+
+  // Scenario: with a rate of 2, only every other access is sampled.
+  bpm->ResetStats();
+  bpm->SetHeatSampleRate(2);
+  for (int j = 0; j < 10; j++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  }
+  hottest = bpm->GetHottestPages(10);
+  ASSERT_EQ(1, hottest.size());
+  EXPECT_EQ(5, hottest[0].second);
+
+  delete bpm;
+  delete disk_manager;
+  RemoveDbFiles("test.db");
+}
+
+}  // namespace bustub
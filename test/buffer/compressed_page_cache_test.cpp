@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/page_compressor.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CompressorTest) {
+  char page[PAGE_SIZE];
+  char compressed[PAGE_SIZE * 2];
+  char decompressed[PAGE_SIZE];
+
+  // Scenario: an empty page shrinks to almost nothing and comes back intact.
+  memset(page, 0, PAGE_SIZE);
+  size_t size = PageCompressor::Compress(page, PAGE_SIZE, compressed, sizeof(compressed));
+  ASSERT_NE(0, size);
+  EXPECT_LT(size, 64);
+  ASSERT_TRUE(PageCompressor::Decompress(compressed, size, decompressed, PAGE_SIZE));
+  EXPECT_EQ(0, memcmp(page, decompressed, PAGE_SIZE));
+
+  // Scenario: repetitive records compress well; random bytes do not, but still round-trip.
+  const int record_size = 32;
+  for (int i = 0; i < PAGE_SIZE; i += record_size) {
+    snprintf(page + i, record_size, "tuple %08d name-%04d", i, i % 7);
+  }
+  size = PageCompressor::Compress(page, PAGE_SIZE, compressed, sizeof(compressed));
+  ASSERT_NE(0, size);
+  EXPECT_LT(size, PAGE_SIZE / 2);
+  ASSERT_TRUE(PageCompressor::Decompress(compressed, size, decompressed, PAGE_SIZE));
+  EXPECT_EQ(0, memcmp(page, decompressed, PAGE_SIZE));
+
+  std::mt19937 rng(15445);
+  for (char &byte : page) {
+    byte = static_cast<char>(rng());
+  }
+  size = PageCompressor::Compress(page, PAGE_SIZE, compressed, sizeof(compressed));
+  ASSERT_NE(0, size);
+  EXPECT_GT(size, PAGE_SIZE);
+  ASSERT_TRUE(PageCompressor::Decompress(compressed, size, decompressed, PAGE_SIZE));
+  EXPECT_EQ(0, memcmp(page, decompressed, PAGE_SIZE));
+
+  // Scenario: output that does not fit is refused, and truncated input is rejected.
+  EXPECT_EQ(0, PageCompressor::Compress(page, PAGE_SIZE, compressed, PAGE_SIZE / 2));
+  EXPECT_FALSE(PageCompressor::Decompress(compressed, size / 2, decompressed, PAGE_SIZE));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, SampleTest) {
+  char page[PAGE_SIZE] = {};
+  char out[PAGE_SIZE];
+  CompressedPageCache cache(100);
+
+  // Scenario: pages are taken out of the cache when they are read back.
+  snprintf(page, PAGE_SIZE, "page 1");
+  ASSERT_TRUE(cache.Put(1, page));
+  EXPECT_EQ(1, cache.Size());
+  ASSERT_TRUE(cache.Take(1, out));
+  EXPECT_STREQ("page 1", out);
+  EXPECT_EQ(0, cache.Size());
+  EXPECT_EQ(0, cache.GetUsedBytes());
+  EXPECT_FALSE(cache.Take(1, out));
+
+  // Scenario: a full cache drops its oldest pages to make room.
+  for (page_id_t page_id = 0; page_id < 20; page_id++) {
+    snprintf(page, PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(cache.Put(page_id, page));
+    EXPECT_LE(cache.GetUsedBytes(), 100);
+  }
+  EXPECT_LT(cache.Size(), 20);
+  EXPECT_FALSE(cache.Take(0, out));
+  ASSERT_TRUE(cache.Take(19, out));
+  EXPECT_STREQ("page 19", out);
+
+  // Scenario: invalidated pages are gone, and incompressible pages are not kept.
+  cache.Invalidate(18);
+  EXPECT_FALSE(cache.Take(18, out));
+  std::mt19937 rng(15445);
+  for (char &byte : page) {
+    byte = static_cast<char>(rng());
+  }
+  CompressedPageCache large_cache(PAGE_SIZE * 4);
+  EXPECT_FALSE(large_cache.Put(1, page));
+  EXPECT_EQ(0, large_cache.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  bpm->SetCompressedTierCapacity(PAGE_SIZE * 4);
+
+  // Scenario: pages evicted from a small pool come back from the compressed tier, not from the disk.
+  const page_id_t num_pages = 6;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(num_pages, stats.misses_);
+  EXPECT_EQ(num_pages, stats.compressed_hits_);
+
+  // Scenario: a page changed after it came back from the tier is not served stale.
+  Page *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), PAGE_SIZE, "page 0 again");
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  for (page_id_t page_id = 1; page_id < num_pages; page_id++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_STREQ("page 0 again", page->GetData());
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  // Scenario: a deleted page is dropped from the tier too.
+  for (page_id_t page_id = 1; page_id < num_pages; page_id++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_TRUE(bpm->DeletePage(0));
+  bpm->ResetStats();
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, bpm->GetStats().compressed_hits_);
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/frame_arena.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, SampleTest) {
+  // Scenario: small and huge-page sized arenas, bound to a NUMA node or not, all hand out aligned, zeroed frames.
+  for (size_t num_frames : {1, 10, 1024}) {
+    for (int numa_node : {FrameArena::NO_NUMA_NODE, 0}) {
+      FrameArena arena(num_frames, numa_node);
+      for (size_t i = 0; i < num_frames; i++) {
+        char *frame = arena.GetFrame(static_cast<frame_id_t>(i));
+        ASSERT_EQ(0, reinterpret_cast<uintptr_t>(frame) % PAGE_SIZE);
+        ASSERT_EQ(arena.GetFrame(0) + i * PAGE_SIZE, frame);
+        ASSERT_EQ(0, frame[0]);
+        ASSERT_EQ(0, frame[PAGE_SIZE - 1]);
+        memset(frame, static_cast<int>(i), PAGE_SIZE);
+      }
+      EXPECT_EQ(static_cast<char>(num_frames - 1), arena.GetFrame(static_cast<frame_id_t>(num_frames - 1))[7]);
+    }
+  }
+  EXPECT_GE(FrameArena::GetNumNumaNodes(), 1);
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolLayoutTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: the metadata of every frame sits on cache lines of its own, and its data is page-aligned.
+  Page *pages = bpm->GetPages();
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&pages[i]) % 64);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[i].GetData()) % PAGE_SIZE);
+  }
+
+  // Scenario: the data of a page written through the pool survives eviction.
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), PAGE_SIZE, "Hello");
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t other_page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&other_page_id));
+    EXPECT_TRUE(bpm->UnpinPage(other_page_id, false));
+  }
+  page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // Scenario: a page outside of any pool owns its own zeroed data.
+  Page standalone;
+  EXPECT_EQ(0, standalone.GetData()[0]);
+  EXPECT_EQ(INVALID_PAGE_ID, standalone.GetPageId());
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
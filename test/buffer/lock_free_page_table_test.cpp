@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lock_free_page_table_test.cpp
+//
+// Identification: test/buffer/lock_free_page_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/lock_free_page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LockFreePageTableTest, SampleTest) {
+  LockFreePageTable page_table(8);
+  frame_id_t frame_id;
+
+  // Scenario: an empty table finds nothing.
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+
+  // Scenario: insert a full pool worth of pages and find them all again.
+  for (int i = 0; i < 8; i++) {
+    page_table.Insert(i * 100, i);
+  }
+  EXPECT_EQ(8, page_table.Size());
+  for (int i = 0; i < 8; i++) {
+    ASSERT_TRUE(page_table.Find(i * 100, &frame_id));
+    EXPECT_EQ(i, frame_id);
+  }
+
+  // Scenario: removed pages disappear, the others stay.
+  EXPECT_TRUE(page_table.Remove(300));
+  EXPECT_FALSE(page_table.Remove(300));
+  EXPECT_FALSE(page_table.Find(300, &frame_id));
+  EXPECT_TRUE(page_table.Find(400, &frame_id));
+  EXPECT_EQ(7, page_table.Size());
+
+  // Scenario: churning through many more pages than slots never fills the table up with tombstones.
+  for (int i = 1000; i < 5000; i++) {
+    page_table.Insert(i, 3);
+    ASSERT_TRUE(page_table.Find(i, &frame_id));
+    EXPECT_EQ(3, frame_id);
+    EXPECT_TRUE(page_table.Remove(i));
+  }
+  EXPECT_FALSE(page_table.Find(4999, &frame_id));
+  EXPECT_EQ(7, page_table.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(LockFreePageTableTest, ConcurrentReadersTest) {
+  const int num_stable = 32;
+  LockFreePageTable page_table(64);
+  for (int i = 0; i < num_stable; i++) {
+    page_table.Insert(i, i);
+  }
+
+  // One writer churns through pages that are not stable while readers keep finding the stable ones.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&] {
+      frame_id_t frame_id;
+      while (!done.load()) {
+        for (int i = 0; i < num_stable; i++) {
+          ASSERT_TRUE(page_table.Find(i, &frame_id));
+          ASSERT_EQ(i, frame_id);
+        }
+      }
+    });
+  }
+  for (int i = num_stable; i < 100000; i++) {
+    page_table.Insert(i, num_stable + i % num_stable);
+    page_table.Remove(i);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+#include "logging/common.h"
+#include "storage/db_files.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_replacer(7, 2);
+
+  // Scenario: access frames 1-6 once each, then access frame 1 again.
+  for (int i = 1; i <= 6; i++) {
+    lru_replacer.Pin(i);
+  }
+  lru_replacer.Pin(1);
+  for (int i = 1; i <= 6; i++) {
+    lru_replacer.Unpin(i);
+  }
+  EXPECT_EQ(6, lru_replacer.Size());
+
+  // Scenario: frames 2-6 have an infinite backward k-distance and go first, oldest access first.
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+
+  // Scenario: a second access to frame 4 gives it a finite k-distance, but a smaller one than frame 1.
+  lru_replacer.Pin(4);
+  lru_replacer.Unpin(4);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(5, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(6, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: pinned frames are never victims, removed frames are forgotten.
+  lru_replacer.Pin(4);
+  EXPECT_EQ(0, lru_replacer.Size());
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+  lru_replacer.Unpin(4);
+  lru_replacer.Remove(4);
+  EXPECT_EQ(0, lru_replacer.Size());
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, FailedEvictionTest) {
+  // Every access counts, however close to the one before.
+  LRUKReplacer lru_replacer(3, 2, 0);
+
+  // Scenario: frame 0 is hot, but it is the only victim.
+  lru_replacer.Pin(0);
+  lru_replacer.Pin(0);
+  lru_replacer.Unpin(0);
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: its page is pinned again before the caller claims the frame, so the eviction never happens.
+  lru_replacer.Pin(0);
+  lru_replacer.Unpin(0);
+  lru_replacer.Pin(1);
+  lru_replacer.Unpin(1);
+
+  // Scenario: frame 0 kept its history and is still hot, so the frame accessed once goes first.
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  lru_replacer.Remove(1);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  lru_replacer.Remove(0);
+  EXPECT_EQ(0, lru_replacer.Size());
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, CorrelatedReferenceTest) {
+  LRUKReplacer lru_replacer(3, 2, 4);
+
+  // Scenario: frame 0 is accessed again and again within the period, frame 1 twice with other accesses in between.
+  lru_replacer.Pin(1);
+  for (int i = 0; i < 4; i++) {
+    lru_replacer.Pin(0);
+    lru_replacer.Unpin(0);
+  }
+  lru_replacer.Pin(1);
+  lru_replacer.Unpin(1);
+
+  // Scenario: frame 0 only has one access on record, so it goes before frame 1.
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  lru_replacer.Remove(0);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 16;
+  const size_t num_hot_pages = 4;
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager(db_name);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+
+  // Scenario: a table of many more pages than the pool holds is loaded through a pool of its own.
+  page_id_t first_page_id;
+  {
+    BufferPoolManagerInstance loading_bpm(buffer_pool_size, disk_manager);
+    TableHeap loading_table(&loading_bpm, lock_manager, log_manager, transaction);
+    RID rid;
+    for (int i = 0; i < 6000; i++) {
+      ASSERT_TRUE(loading_table.InsertTuple(tuple, &rid, transaction));
+    }
+    first_page_id = loading_table.GetFirstPageId();
+    loading_bpm.FlushAllPages();
+  }
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU_K, 2);
+  auto *table = new TableHeap(bpm, lock_manager, log_manager, first_page_id);
+
+  // Scenario: a few hot pages are each fetched twice, with other pages fetched in between.
+  std::vector<page_id_t> hot;
+  for (size_t i = 0; i < num_hot_pages; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    snprintf(bpm->FetchPage(page_id)->GetData(), PAGE_SIZE, "hot %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    hot.push_back(page_id);
+  }
+  for (page_id_t page_id : hot) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a sequential scan goes back to each page for every tuple on it, but that is one reference per page.
+  size_t num_tuples = 0;
+  std::vector<page_id_t> scanned;
+  for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+    num_tuples++;
+    if (scanned.empty() || scanned.back() != itr->GetRid().GetPageId()) {
+      scanned.push_back(itr->GetRid().GetPageId());
+    }
+  }
+  EXPECT_EQ(6000, num_tuples);
+  ASSERT_GT(scanned.size(), 2 * buffer_pool_size);
+
+  // Scenario: the hot pages survived the scan without being read back.
+  uint64_t misses = bpm->GetStats().misses_;
+  for (page_id_t page_id : hot) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("hot " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(misses, bpm->GetStats().misses_);
+
+  disk_manager->ShutDown();
+  RemoveDbFiles(db_name);
+  delete table;
+  delete bpm;
+  delete log_manager;
+  delete lock_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+}  // namespace bustub
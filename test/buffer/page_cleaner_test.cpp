@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_cleaner_test.cpp
+//
+// Identification: test/buffer/page_cleaner_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, ColdFramesTest) {
+  // Scenario: the clock lists frames whose reference bit is clear before the others, starting at the hand.
+  ClockReplacer clock_replacer(7);
+  for (frame_id_t frame_id = 1; frame_id <= 4; frame_id++) {
+    clock_replacer.Unpin(frame_id);
+  }
+  frame_id_t victim;
+  ASSERT_TRUE(clock_replacer.Victim(&victim));
+  EXPECT_EQ(1, victim);
+  clock_replacer.Unpin(1);
+  EXPECT_EQ((std::vector<frame_id_t>{2, 3, 4, 1}), clock_replacer.ColdFrames(10));
+  EXPECT_EQ((std::vector<frame_id_t>{2, 3}), clock_replacer.ColdFrames(2));
+  EXPECT_EQ(4, clock_replacer.Size());
+
+  // Scenario: LRU-K lists frames with fewer than k accesses first.
+  LRUKReplacer lru_replacer(7, 2, 0);
+  for (frame_id_t frame_id = 1; frame_id <= 3; frame_id++) {
+    lru_replacer.Pin(frame_id);
+  }
+  lru_replacer.Pin(1);
+  for (frame_id_t frame_id = 1; frame_id <= 3; frame_id++) {
+    lru_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ((std::vector<frame_id_t>{2, 3, 1}), lru_replacer.ColdFrames(10));
+  EXPECT_EQ(3, lru_replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: five dirty unpinned pages and one dirty pinned page.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 6; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[5]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[5], true));
+
+  // Scenario: a pass writes back exactly the unpinned dirty pages, and leaves them resident.
+  int writes = disk_manager->GetNumWrites();
+  EXPECT_EQ(5, bpm->CleanColdPages(buffer_pool_size));
+  EXPECT_EQ(writes + 5, disk_manager->GetNumWrites());
+  EXPECT_EQ(0, bpm->CleanColdPages(buffer_pool_size));
+  for (int i = 0; i < 5; i++) {
+    EXPECT_FALSE(bpm->GetPages()[i].IsDirty());
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+  EXPECT_TRUE(bpm->GetPages()[5].IsDirty());
+
+  // Scenario: evicting the cleaned pages does not write them again, and their contents survived.
+  writes = disk_manager->GetNumWrites();
+  for (int i = 0; i < 9; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(writes, disk_manager->GetNumWrites());
+  Page *page = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(page_ids[0]), std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, WriteAheadLogTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, log_manager);
+  enable_logging = true;
+
+  // Scenario: a page whose last change is not in the persistent log yet is not written back.
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  page->SetLSN(10);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  log_manager->SetPersistentLSN(9);
+  EXPECT_EQ(0, bpm->CleanColdPages());
+  EXPECT_TRUE(page->IsDirty());
+
+  // Scenario: it is, once the log has caught up.
+  log_manager->SetPersistentLSN(10);
+  EXPECT_EQ(1, bpm->CleanColdPages());
+  EXPECT_FALSE(page->IsDirty());
+
+  enable_logging = false;
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete log_manager;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, BackgroundTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_cleaner_interval = std::chrono::milliseconds(10);
+  bpm->RunPageCleaner();
+
+  // Scenario: dirty pages left unpinned are written back without anybody asking.
+  for (int i = 0; i < 5; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (int i = 0; i < 500 && disk_manager->GetNumWrites() < 5; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(5, disk_manager->GetNumWrites());
+
+  bpm->StopPageCleaner();
+  page_cleaner_interval = std::chrono::milliseconds(100);
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,254 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up every instance.
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: Once every instance is full, we should not be able to create any new pages, nor allocate ids for them.
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, disk_manager->GetNumFreePages());
+
+  // Scenario: Pages are spread across the instances by page id.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size * num_instances); ++page_id) {
+    EXPECT_EQ(bpm->GetBufferPoolManager(page_id), bpm->GetBufferPoolManager(page_id + num_instances));
+    EXPECT_NE(bpm->GetBufferPoolManager(page_id), bpm->GetBufferPoolManager(page_id + 1));
+  }
+
+  // Scenario: After unpinning page 0 and pinning a new page, we should still be able to read page 0 back from disk.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  page_id_t new_page_id;
+  EXPECT_NE(nullptr, bpm->NewPage(&new_page_id));
+  EXPECT_EQ(true, bpm->UnpinPage(new_page_id, false));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, FlushAllPagesTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 3;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Scenario: pages spread over every instance; even ones are dirty, odd ones clean, the last one still pinned.
+  const page_id_t num_pages = 10;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    if (page_id + 1 < num_pages) {
+      EXPECT_TRUE(bpm->UnpinPage(page_id, page_id % 2 == 0));
+    }
+  }
+
+  // Scenario: only the dirty and the pinned pages are written, and a second flush has nothing left to write.
+  int writes = disk_manager->GetNumWrites();
+  bpm->FlushAllPages();
+  EXPECT_EQ(writes + 6, disk_manager->GetNumWrites());
+  bpm->UnpinPage(num_pages - 1, false);
+  bpm->FlushAllPages();
+  EXPECT_EQ(writes + 6, disk_manager->GetNumWrites());
+
+  // Scenario: the flushed pages can be read back from disk, and the flush left no pins behind.
+  char buf[PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < num_pages; page_id += 2) {
+    disk_manager->ReadPage(page_id, buf);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+  }
+  for (page_id_t page_id = num_pages; page_id < num_pages + static_cast<page_id_t>(buffer_pool_size * num_instances);
+       page_id++) {
+    page_id_t new_page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&new_page_id));
+  }
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 2;
+  const size_t num_instances = 3;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, nullptr,
+                                            ReplacerType::CLOCK, LRUK_REPLACER_K, false, 4);
+
+  // Scenario: growing spreads the new frames over the instances, as evenly as possible.
+  EXPECT_TRUE(bpm->Resize(10));
+  EXPECT_EQ(10, bpm->GetPoolSize());
+  EXPECT_EQ(4, bpm->GetBufferPoolManager(0)->GetPoolSize());
+  EXPECT_EQ(3, bpm->GetBufferPoolManager(1)->GetPoolSize());
+  EXPECT_EQ(3, bpm->GetBufferPoolManager(2)->GetPoolSize());
+  EXPECT_FALSE(bpm->Resize(num_instances * 4 + 1));
+  EXPECT_FALSE(bpm->Resize(num_instances - 1));
+
+  // Scenario: if one instance cannot shrink, the others are put back as they were.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 10; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+  for (page_id_t page_id : page_ids) {
+    if (page_id % num_instances != 2) {
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+  }
+  EXPECT_FALSE(bpm->Resize(num_instances));
+  EXPECT_EQ(10, bpm->GetPoolSize());
+  EXPECT_EQ(4, bpm->GetBufferPoolManager(0)->GetPoolSize());
+
+  // Scenario: once nothing is pinned, the pool shrinks and every page survives.
+  for (page_id_t page_id : page_ids) {
+    if (page_id % num_instances == 2) {
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+  }
+  EXPECT_TRUE(bpm->Resize(num_instances));
+  EXPECT_EQ(num_instances, bpm->GetPoolSize());
+  for (page_id_t page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, NewPageInExtentTest) {
+  RemoveDbFiles("test.db");
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new ParallelBufferPoolManager(2, 1, disk_manager);
+  PageExtent extent(4);
+
+  // Scenario: pages of an extent are consecutive, so they go round the instances.
+  page_id_t first_page_id;
+  page_id_t second_page_id;
+  ASSERT_NE(nullptr, bpm->NewPageInExtent(&first_page_id, &extent));
+  ASSERT_NE(nullptr, bpm->NewPageInExtent(&second_page_id, &extent));
+  EXPECT_EQ(first_page_id + 1, second_page_id);
+
+  // Scenario: the instance of the next page of the extent is full, but another one has room.
+  EXPECT_TRUE(bpm->UnpinPage(second_page_id, true));
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPageInExtent(&page_id, &extent));
+  EXPECT_EQ(second_page_id % 2, page_id % 2);
+
+  // Scenario: every frame is pinned.
+  EXPECT_EQ(nullptr, bpm->NewPageInExtent(&page_id, &extent));
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t num_threads = 8;
+  const size_t pages_per_thread = 20;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 8, disk_manager);
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm] {
+      std::vector<page_id_t> page_ids;
+      for (size_t i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+        page_ids.push_back(page_id);
+      }
+      for (auto page_id : page_ids) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(page_id, std::stoi(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
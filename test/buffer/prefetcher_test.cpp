@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefetcher_test.cpp
+//
+// Identification: test/buffer/prefetcher_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/prefetcher.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PrefetcherTest, SampleTest) {
+  // Pages form a chain 0 -> 1 -> ... -> 9.
+  std::vector<page_id_t> loaded;
+  Prefetcher prefetcher([&](page_id_t page_id, const BufferPoolManager::next_page_fn &next_page) {
+    loaded.push_back(page_id);
+    if (next_page == nullptr) {
+      return INVALID_PAGE_ID;
+    }
+    return page_id + 1 < 10 ? page_id + 1 : INVALID_PAGE_ID;
+  });
+  auto next_page = [](Page * /*page*/) { return INVALID_PAGE_ID; };
+
+  // Scenario: nothing is loaded, and no thread is needed, for requests that have nothing to read.
+  prefetcher.Enqueue(INVALID_PAGE_ID, 4, next_page);
+  prefetcher.Enqueue(3, 0, next_page);
+  prefetcher.WaitUntilIdle();
+  EXPECT_TRUE(loaded.empty());
+
+  // Scenario: a request follows the chain for depth pages.
+  prefetcher.Enqueue(2, 3, next_page);
+  prefetcher.WaitUntilIdle();
+  EXPECT_EQ((std::vector<page_id_t>{2, 3, 4}), loaded);
+
+  // Scenario: the chain ends before depth is reached.
+  loaded.clear();
+  prefetcher.Enqueue(8, 5, next_page);
+  prefetcher.WaitUntilIdle();
+  EXPECT_EQ((std::vector<page_id_t>{8, 9}), loaded);
+
+  // Scenario: nothing is loaded once stopped.
+  loaded.clear();
+  prefetcher.Stop();
+  prefetcher.Enqueue(0, 1, nullptr);
+  prefetcher.WaitUntilIdle();
+  EXPECT_TRUE(loaded.empty());
+}
+
+// NOLINTNEXTLINE
+TEST(PrefetcherTest, ReadAheadTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  // Write a chain of pages, each holding the id of the next one.
+  {
+    BufferPoolManagerInstance bpm(buffer_pool_size, disk_manager);
+    for (page_id_t i = 0; i < 5; i++) {
+      page_id_t page_id;
+      Page *page = bpm.NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      page_id_t next_page_id = i + 1 < 5 ? i + 1 : INVALID_PAGE_ID;
+      memcpy(page->GetData(), &next_page_id, sizeof(page_id_t));
+      EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+    }
+    bpm.FlushAllPages();
+  }
+
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  auto next_page = [](Page *page) { return *reinterpret_cast<page_id_t *>(page->GetData()); };
+
+  // Scenario: a page is read in unpinned, and the next page of the chain is reported.
+  EXPECT_EQ(1, bpm->ReadAhead(0, next_page));
+  EXPECT_EQ(INVALID_PAGE_ID, bpm->ReadAhead(1, nullptr));
+  EXPECT_EQ(0, bpm->GetPages()[0].GetPinCount());
+  EXPECT_EQ(0, bpm->GetPages()[1].GetPinCount());
+
+  // Scenario: a resident page is not read again, but still lets us follow the chain.
+  EXPECT_EQ(2, bpm->ReadAhead(1, next_page));
+  EXPECT_EQ(INVALID_PAGE_ID, bpm->ReadAhead(4, next_page));
+
+  // Scenario: the first fetch of a read-ahead page counts as loading it for the scan's ring.
+  BufferAccessStrategy strategy(bpm, 1);
+  Page *page = bpm->FetchPageWithStrategy(0, &strategy);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1, next_page(page));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  page = bpm->FetchPageWithStrategy(1, &strategy);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  EXPECT_EQ(1, strategy.GetNumReleased());
+  page = bpm->FetchPageWithStrategy(1, &strategy);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  EXPECT_EQ(1, strategy.GetNumReleased());
+
+  // Scenario: read-ahead pages can be evicted like any other unpinned page.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  // Scenario: read-ahead gives up instead of waiting when every frame is pinned.
+  EXPECT_EQ(INVALID_PAGE_ID, bpm->ReadAhead(3, next_page));
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark_test.cpp
+//
+// Identification: test/buffer/replacer_benchmark_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/access_trace.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/replacer_benchmark.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ReplacerBenchmarkTest, RecordTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+  page_id_t page_id;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: only fetches made with the callback while recording end up in the trace.
+  AccessTrace trace;
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessTrace::RecordCallback));
+  AccessTrace::StartRecording(&trace);
+  for (page_id_t page_id : {2, 0, 2, 1}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id, AccessTrace::RecordCallback));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(1));
+  AccessTrace::StopRecording();
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessTrace::RecordCallback));
+  EXPECT_EQ((std::vector<page_id_t>{2, 0, 2, 1}), trace.GetAccesses());
+
+  // Scenario: a saved trace loads back the same.
+  const std::string trace_name = "test.trace";
+  ASSERT_TRUE(trace.Save(trace_name));
+  AccessTrace loaded;
+  ASSERT_TRUE(AccessTrace::Load(trace_name, &loaded));
+  EXPECT_EQ(trace.GetAccesses(), loaded.GetAccesses());
+  EXPECT_FALSE(AccessTrace::Load("no_such.trace", &loaded));
+  remove(trace_name.c_str());
+
+  delete bpm;
+  delete disk_manager;
+  RemoveDbFiles("test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(ReplacerBenchmarkTest, ReplayTest) {
+  const size_t num_frames = 4;
+  std::vector<page_id_t> working_set;
+  std::vector<page_id_t> loop;
+  for (int round = 0; round < 10; round++) {
+    for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); page_id++) {
+      working_set.push_back(page_id);
+    }
+    for (page_id_t page_id = 0; page_id <= static_cast<page_id_t>(num_frames); page_id++) {
+      loop.push_back(page_id);
+    }
+  }
+
+  for (ReplacerType replacer_type : {ReplacerType::CLOCK, ReplacerType::LRU_K, ReplacerType::TWO_QUEUE}) {
+    SCOPED_TRACE(ReplacerBenchmark::PolicyName(replacer_type));
+
+    // Scenario: a working set that fits only misses on its first pass.
+    std::unique_ptr<Replacer> replacer(Replacer::Create(replacer_type, num_frames));
+    ReplayResult result = ReplacerBenchmark::Replay(AccessTrace(working_set), replacer.get(), num_frames);
+    EXPECT_EQ(working_set.size(), result.accesses_);
+    EXPECT_EQ(working_set.size() - num_frames, result.hits_);
+    EXPECT_GT(result.throughput_, 0);
+    EXPECT_LE(result.p50_ns_, result.p99_ns_);
+    EXPECT_LE(result.p99_ns_, result.max_ns_);
+
+    // Scenario: every policy replays the same trace to completion, whatever it decides to evict.
+    replacer.reset(Replacer::Create(replacer_type, num_frames));
+    result = ReplacerBenchmark::Replay(AccessTrace(loop), replacer.get(), num_frames);
+    EXPECT_EQ(loop.size(), result.accesses_);
+    EXPECT_LT(result.hits_, loop.size());
+  }
+
+  // Scenario: the clock degenerates to LRU on a loop one page larger than the pool, and never hits.
+  std::unique_ptr<Replacer> clock(Replacer::Create(ReplacerType::CLOCK, num_frames));
+  EXPECT_EQ(0, ReplacerBenchmark::Replay(AccessTrace(loop), clock.get(), num_frames).hits_);
+
+  // Scenario: a pool without frames replays nothing.
+  EXPECT_EQ(0, ReplacerBenchmark::Replay(AccessTrace(loop), clock.get(), 0).accesses_);
+}
+
+}  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer_test.cpp
+//
+// Identification: test/buffer/two_queue_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // A1 may hold 2 of the 8 frames before it is drained first. Every access counts, however close to the one before.
+  TwoQueueReplacer replacer(8, 0);
+
+  // Scenario: frames 0 and 1 are accessed twice and move to Am.
+  for (int i = 0; i < 2; i++) {
+    replacer.Pin(i);
+    replacer.Unpin(i);
+    replacer.Pin(i);
+    replacer.Unpin(i);
+  }
+
+  // Scenario: frames 2-5 are accessed once each and stay in A1.
+  for (int i = 2; i < 6; i++) {
+    replacer.Pin(i);
+    replacer.Unpin(i);
+  }
+  EXPECT_EQ(6, replacer.Size());
+
+  // Scenario: A1 is over its share, so it is drained in FIFO order until it is back within its share.
+  int value;
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+
+  // Scenario: within its share, A1 is left alone and Am is evicted in LRU order.
+  replacer.Pin(0);
+  replacer.Unpin(0);
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: once Am is empty, A1 is used regardless of its size.
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+
+  // Scenario: pinned and removed frames are never victims.
+  replacer.Pin(5);
+  EXPECT_FALSE(replacer.Victim(&value));
+  replacer.Unpin(5);
+  replacer.Remove(5);
+  EXPECT_EQ(0, replacer.Size());
+  EXPECT_FALSE(replacer.Victim(&value));
+}
+
+// NOLINTNEXTLINE
+TEST(TwoQueueReplacerTest, FailedEvictionTest) {
+  // A1 may hold 2 of the 8 frames before it is drained first. Every access counts, however close to the one before.
+  TwoQueueReplacer replacer(8, 0);
+
+  // Scenario: frame 0 is in Am, and it is the only victim.
+  replacer.Pin(0);
+  replacer.Unpin(0);
+  replacer.Pin(0);
+  replacer.Unpin(0);
+  int value;
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: its page is pinned again before the caller claims the frame, so the eviction never happens.
+  replacer.Pin(0);
+  replacer.Unpin(0);
+  for (int i = 1; i <= 3; i++) {
+    replacer.Pin(i);
+    replacer.Unpin(i);
+  }
+
+  // Scenario: frame 0 stayed in Am instead of starting over in A1, so the over-full A1 is drained first.
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  replacer.Remove(1);
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  replacer.Remove(0);
+
+  // Scenario: confirmed evictions left A1 counted correctly, and it is used once Am is empty.
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  replacer.Remove(2);
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  replacer.Remove(3);
+  EXPECT_EQ(0, replacer.Size());
+  EXPECT_FALSE(replacer.Victim(&value));
+}
+
+// NOLINTNEXTLINE
+TEST(TwoQueueReplacerTest, CorrelatedReferenceTest) {
+  TwoQueueReplacer replacer(8, 4);
+
+  // Scenario: frame 0 is accessed again and again within the period, frame 1 twice with other accesses in between.
+  replacer.Pin(1);
+  replacer.Unpin(1);
+  for (int i = 0; i < 4; i++) {
+    replacer.Pin(0);
+    replacer.Unpin(0);
+  }
+  replacer.Pin(1);
+  replacer.Unpin(1);
+
+  // Scenario: only frame 1 made it to Am, so with A1 within its share it goes first.
+  int value;
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  replacer.Remove(1);
+  ASSERT_TRUE(replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+}
+
+}  // namespace bustub
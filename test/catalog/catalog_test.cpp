@@ -14,17 +14,19 @@
 #include <unordered_set>
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "catalog/simple_catalog.h"
 #include "gtest/gtest.h"
+#include "storage/db_files.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 TEST(CatalogTest, DISABLED_CreateTableTest) {
+  RemoveDbFiles("catalog_test.db");
   auto disk_manager = new DiskManager("catalog_test.db");
-  auto bpm = new BufferPoolManager(32, disk_manager);
+  auto bpm = new BufferPoolManagerInstance(32, disk_manager);
   auto catalog = new SimpleCatalog(bpm, nullptr, nullptr);
   std::string table_name = "potato";
 
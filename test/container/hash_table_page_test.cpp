@@ -13,9 +13,10 @@
 #include <thread>  // NOLINT
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/logger.h"
 #include "gtest/gtest.h"
+#include "storage/db_files.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/hash_table_block_page.h"
 #include "storage/page/hash_table_header_page.h"
@@ -24,8 +25,9 @@ namespace bustub {
 
 // NOLINTNEXTLINE
 TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
+  RemoveDbFiles("test.db");
   DiskManager *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(5, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
   // get a header page from the BufferPoolManager
   page_id_t header_page_id = INVALID_PAGE_ID;
@@ -55,15 +57,16 @@ TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
   // unpin the header page now that we are done
   bpm->UnpinPage(header_page_id, true, nullptr);
   disk_manager->ShutDown();
-  remove("test.db");
+  RemoveDbFiles("test.db");
   delete disk_manager;
   delete bpm;
 }
 
 // NOLINTNEXTLINE
 TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
+  RemoveDbFiles("test.db");
   DiskManager *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(5, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
   // get a block page from the BufferPoolManager
   page_id_t block_page_id = INVALID_PAGE_ID;
@@ -106,7 +109,7 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
   // unpin the header page now that we are done
   bpm->UnpinPage(block_page_id, true, nullptr);
   disk_manager->ShutDown();
-  remove("test.db");
+  RemoveDbFiles("test.db");
   delete disk_manager;
   delete bpm;
 }
@@ -10,20 +10,26 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
 #include <thread>  // NOLINT
 #include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/logger.h"
 #include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/db_files.h"
+#include "storage/page/hash_table_block_page.h"
+#include "storage/page/hash_table_header_page.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 TEST(HashTableTest, DISABLED_SampleTest) {
+  RemoveDbFiles("test.db");
   auto *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(50, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
 
   LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
 
@@ -99,9 +105,29 @@ TEST(HashTableTest, DISABLED_SampleTest) {
     }
   }
   disk_manager->ShutDown();
-  remove("test.db");
+  RemoveDbFiles("test.db");
   delete disk_manager;
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, PageSizeTest) {
+  // Scenario: the hash table pages fit in a PAGE_SIZE page, so pools of pages that large or larger can host them.
+  EXPECT_LE(sizeof(HashTableHeaderPage), PAGE_SIZE);
+  EXPECT_LE(sizeof(HashTableBlockPage<int, int, IntComparator>), PAGE_SIZE);
+  for (size_t page_size : {static_cast<size_t>(PAGE_SIZE), size_t{16 * 1024}}) {
+    RemoveDbFiles("test.db");
+    DiskManager disk_manager("test.db", false, page_size);
+    BufferPoolManagerInstance bpm(4, &disk_manager);
+    EXPECT_NO_THROW(
+        (LinearProbeHashTable<int, int, IntComparator>("blah", &bpm, IntComparator(), 1000, HashFunction<int>())));
+    disk_manager.ShutDown();
+    RemoveDbFiles("test.db");
+  }
+
+  // Scenario: no file may use smaller pages, so there is no pool a hash page could overrun.
+  EXPECT_FALSE(DiskManager::IsValidPageSize(PAGE_SIZE / 2));
+  EXPECT_FALSE(DiskManager::IsValidPageSize(1024));
+}
+
 }  // namespace bustub
@@ -17,7 +17,7 @@
 #include <utility>
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "catalog/table_generator.h"
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
@@ -31,6 +31,7 @@
 #include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "gtest/gtest.h"
+#include "storage/db_files.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -41,8 +42,9 @@ class ExecutorTest : public ::testing::Test {
   void SetUp() override {
     ::testing::Test::SetUp();
     // For each test, we create a new DiskManager, BufferPoolManager, TransactionManager, and SimpleCatalog.
+    RemoveDbFiles("executor_test.db");
     disk_manager_ = std::make_unique<DiskManager>("executor_test.db");
-    bpm_ = std::make_unique<BufferPoolManager>(32, disk_manager_.get());
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(32, disk_manager_.get());
     txn_mgr_ = std::make_unique<TransactionManager>(lock_manager_.get(), log_manager_.get());
     catalog_ = std::make_unique<SimpleCatalog>(bpm_.get(), lock_manager_.get(), log_manager_.get());
     // Begin a new transaction, along with its executor context.
@@ -59,7 +61,7 @@ class ExecutorTest : public ::testing::Test {
     txn_mgr_->Commit(txn_);
     // Shut down the disk manager and clean up the transaction.
     disk_manager_->ShutDown();
-    remove("executor_test.db");
+    RemoveDbFiles("executor_test.db");
     delete txn_;
   };
 
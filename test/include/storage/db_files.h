@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// db_files.h
+//
+// Identification: test/include/storage/db_files.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+namespace bustub {
+
+/**
+ * Removes a database file along with the log and the free space map that DiskManager keeps next to it. Tests call it
+ * before and after they use the file, since a disk manager numbers its pages after whatever an earlier test, or a
+ * crashed run of it, left behind.
+ */
+inline void RemoveDbFiles(const std::string &db_file) {
+  std::string stem = db_file.substr(0, db_file.find('.'));
+  remove(db_file.c_str());
+  remove((stem + ".log").c_str());
+  remove((stem + ".fsm").c_str());
+}
+
+}  // namespace bustub
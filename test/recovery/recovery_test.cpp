@@ -20,6 +20,7 @@
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "recovery/log_recovery.h"
+#include "storage/db_files.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
@@ -28,8 +29,7 @@ namespace bustub {
 
 // NOLINTNEXTLINE
 TEST(RecoveryTest, DISABLED_RedoTest) {
-  remove("test.db");
-  remove("test.log");
+  RemoveDbFiles("test.db");
 
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
@@ -88,7 +88,8 @@ TEST(RecoveryTest, DISABLED_RedoTest) {
   delete txn;
 
   LOG_INFO("Begin recovery");
-  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_,
+                                       bustub_instance->log_manager_->GetLogBufferSize());
 
   ASSERT_FALSE(enable_logging);
 
@@ -117,14 +118,12 @@ TEST(RecoveryTest, DISABLED_RedoTest) {
 
   delete bustub_instance;
   LOG_INFO("Tearing down the system..");
-  remove("test.db");
-  remove("test.log");
+  RemoveDbFiles("test.db");
 }
 
 // NOLINTNEXTLINE
 TEST(RecoveryTest, DISABLED_UndoTest) {
-  remove("test.db");
-  remove("test.log");
+  RemoveDbFiles("test.db");
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   ASSERT_FALSE(enable_logging);
@@ -177,7 +176,8 @@ TEST(RecoveryTest, DISABLED_UndoTest) {
   delete txn;
 
   LOG_INFO("Recovery started..");
-  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_,
+                                       bustub_instance->log_manager_->GetLogBufferSize());
 
   ASSERT_FALSE(enable_logging);
 
@@ -201,14 +201,12 @@ TEST(RecoveryTest, DISABLED_UndoTest) {
 
   delete bustub_instance;
   LOG_INFO("Tearing down the system..");
-  remove("test.db");
-  remove("test.log");
+  RemoveDbFiles("test.db");
 }
 
 // NOLINTNEXTLINE
 TEST(RecoveryTest, DISABLED_CheckpointTest) {
-  remove("test.db");
-  remove("test.log");
+  RemoveDbFiles("test.db");
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   EXPECT_FALSE(enable_logging);
@@ -311,7 +309,6 @@ TEST(RecoveryTest, DISABLED_CheckpointTest) {
   delete bustub_instance;
 
   LOG_INFO("Tearing down the system..");
-  remove("test.db");
-  remove("test.log");
+  RemoveDbFiles("test.db");
 }
 }  // namespace bustub
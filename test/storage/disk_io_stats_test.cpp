@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_io_stats_test.cpp
+//
+// Identification: test/storage/disk_io_stats_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+#include "storage/disk/disk_io_stats.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(DiskIOStatsTest, SampleTest) {
+  DiskIOStats stats;
+
+  // Scenario: latencies land in power-of-two buckets, and percentiles round up to a bucket boundary.
+  for (int i = 0; i < 98; i++) {
+    stats.Record(IOOperation::READ, IOTag::TABLE_HEAP, PAGE_SIZE, std::chrono::microseconds(3));
+  }
+  stats.Record(IOOperation::READ, IOTag::TABLE_HEAP, PAGE_SIZE, std::chrono::nanoseconds(500));
+  stats.Record(IOOperation::READ, IOTag::PREFETCH, PAGE_SIZE, std::chrono::milliseconds(10));
+  DiskIOCounters counters = stats.GetCounters();
+  const IOHistogram &table_reads = counters.Get(IOOperation::READ, IOTag::TABLE_HEAP);
+  EXPECT_EQ(99, table_reads.count_);
+  EXPECT_EQ(99 * PAGE_SIZE, table_reads.bytes_);
+  EXPECT_EQ(1, table_reads.buckets_[0]);
+  EXPECT_EQ(98, table_reads.buckets_[2]);
+  EXPECT_EQ(4, table_reads.PercentileMicros(0.5));
+  EXPECT_EQ(1, table_reads.PercentileMicros(0.001));
+
+  // Scenario: summed over tags, the slow prefetch is the tail.
+  IOHistogram reads = counters.Get(IOOperation::READ);
+  EXPECT_EQ(100, reads.count_);
+  EXPECT_EQ(4, reads.PercentileMicros(0.99));
+  EXPECT_EQ(16384, reads.PercentileMicros(1));
+  EXPECT_NE(std::string::npos, counters.ToString().find("read.prefetch: count 1"));
+  EXPECT_EQ(0, counters.Get(IOOperation::WRITE).count_);
+  EXPECT_EQ(0, counters.Get(IOOperation::WRITE).PercentileMicros(0.99));
+
+  // Scenario: a reset forgets everything.
+  stats.Reset();
+  EXPECT_EQ(0, stats.GetCounters().Get(IOOperation::READ).count_);
+
+  // Scenario: tag scopes nest, and are per thread.
+  EXPECT_EQ(IOTag::OTHER, IOTagScope::Current());
+  {
+    IOTagScope outer(IOTag::HASH_INDEX);
+    {
+      IOTagScope inner(IOTag::TEMP);
+      EXPECT_EQ(IOTag::TEMP, IOTagScope::Current());
+      std::thread([] { EXPECT_EQ(IOTag::OTHER, IOTagScope::Current()); }).join();
+    }
+    EXPECT_EQ(IOTag::HASH_INDEX, IOTagScope::Current());
+  }
+  EXPECT_EQ(IOTag::OTHER, IOTagScope::Current());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskIOStatsTest, DiskManagerTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  DiskManager dm(db_file);
+  char data[PAGE_SIZE] = {0};
+  char log_data[64] = {0};
+
+  // Scenario: reads, writes and log writes are counted under the tag of the calling thread.
+  {
+    IOTagScope io_tag(IOTag::TABLE_HEAP);
+    dm.WritePage(0, data);
+    dm.ReadPage(0, data);
+  }
+  dm.ReadPage(0, data);
+  dm.WriteLog(log_data, sizeof(log_data));
+  DiskIOCounters counters = dm.GetIOStats();
+  EXPECT_EQ(1, counters.Get(IOOperation::WRITE, IOTag::TABLE_HEAP).count_);
+  EXPECT_EQ(PAGE_SIZE, counters.Get(IOOperation::WRITE, IOTag::TABLE_HEAP).bytes_);
+  EXPECT_EQ(1, counters.Get(IOOperation::READ, IOTag::TABLE_HEAP).count_);
+  EXPECT_EQ(1, counters.Get(IOOperation::READ, IOTag::OTHER).count_);
+  EXPECT_EQ(1, counters.Get(IOOperation::LOG_WRITE, IOTag::LOG).count_);
+  EXPECT_EQ(sizeof(log_data), counters.Get(IOOperation::LOG_WRITE, IOTag::LOG).bytes_);
+  EXPECT_EQ(1, counters.Get(IOOperation::SYNC, IOTag::LOG).count_);
+
+  // Scenario: an asynchronous I/O keeps the tag of the thread that started it, not the backend's.
+  dm.ResetIOStats();
+  {
+    IOTagScope io_tag(IOTag::TEMP);
+    dm.WritePageAsync(1, data, [](bool success) { EXPECT_TRUE(success); });
+  }
+  dm.WaitForAsyncIO();
+  EXPECT_EQ(1, dm.GetIOStats().Get(IOOperation::WRITE, IOTag::TEMP).count_);
+  EXPECT_EQ(1, dm.GetIOStats().Get(IOOperation::WRITE).count_);
+
+  // Scenario: the write-back of a dirty victim is tagged as an eviction, whoever fetched the page that replaced it.
+  dm.ResetIOStats();
+  {
+    BufferPoolManagerInstance bpm(1, &dm);
+    IOTagScope io_tag(IOTag::TABLE_HEAP);
+    page_id_t first_page_id;
+    page_id_t second_page_id;
+    ASSERT_NE(nullptr, bpm.NewPage(&first_page_id));
+    ASSERT_TRUE(bpm.UnpinPage(first_page_id, true));
+    ASSERT_NE(nullptr, bpm.NewPage(&second_page_id));
+    ASSERT_TRUE(bpm.UnpinPage(second_page_id, false));
+    ASSERT_NE(nullptr, bpm.FetchPage(first_page_id));
+    ASSERT_TRUE(bpm.UnpinPage(first_page_id, false));
+  }
+  counters = dm.GetIOStats();
+  EXPECT_EQ(1, counters.Get(IOOperation::WRITE, IOTag::EVICTION).count_);
+  EXPECT_EQ(0, counters.Get(IOOperation::WRITE, IOTag::TABLE_HEAP).count_);
+  EXPECT_EQ(1, counters.Get(IOOperation::READ, IOTag::TABLE_HEAP).count_);
+
+  // Scenario: copies out of the mapping of the file are counted apart from reads that go to the file.
+  dm.ResetIOStats();
+  if (dm.EnableMappedReads()) {
+    dm.ReadPage(0, data);
+    EXPECT_EQ(1, dm.GetIOStats().Get(IOOperation::MAPPED_READ).count_);
+    EXPECT_EQ(0, dm.GetIOStats().Get(IOOperation::READ).count_);
+  }
+
+  dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+}  // namespace bustub
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory_test.cpp
+//
+// Identification: test/storage/disk_manager_memory_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(DiskManagerMemoryTest, ReadWriteTest) {
+  DiskManagerMemory dm;
+  char data[PAGE_SIZE] = {0};
+  char buf[PAGE_SIZE];
+
+  // Scenario: pages that were never written read as zeros, written ones read back.
+  std::memset(buf, 1, PAGE_SIZE);
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(0, buf[0]);
+  snprintf(data, PAGE_SIZE, "in memory");
+  dm.WritePage(3, data);
+  dm.ReadPage(3, buf);
+  EXPECT_EQ("in memory", std::string(buf));
+
+  // Scenario: batches, and asynchronous requests, which complete on the backend thread like on a file.
+  std::vector<std::pair<page_id_t, const char *>> batch = {{5, data}, {4, data}};
+  dm.WritePages(&batch);
+  bool read = false;
+  std::thread::id callback_thread;
+  dm.ReadPageAsync(5, buf, [&](bool success) {
+    read = success;
+    callback_thread = std::this_thread::get_id();
+  });
+  dm.WaitForAsyncIO();
+  EXPECT_TRUE(read);
+  EXPECT_NE(std::this_thread::get_id(), callback_thread);
+  EXPECT_EQ("in memory", std::string(buf));
+  EXPECT_EQ(3, dm.GetNumWrites());
+
+  // Scenario: the log is kept too.
+  char log[] = "log records";
+  dm.WriteLog(log, sizeof(log));
+  EXPECT_EQ(1, dm.GetNumFlushes());
+  char log_buf[64];
+  EXPECT_TRUE(dm.ReadLog(log_buf, sizeof(log_buf), 0));
+  EXPECT_STREQ("log records", log_buf);
+  EXPECT_FALSE(dm.ReadLog(log_buf, sizeof(log_buf), sizeof(log)));
+
+  // Scenario: a buffer pool runs on top of it like on a file.
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(2, &dm);
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 8; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  for (page_id_t page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerMemoryTest, SimulatedDiskTest) {
+  char data[PAGE_SIZE] = {0};
+
+  // Scenario: every request waits for the latency.
+  SimulatedDisk slow_disk;
+  slow_disk.read_latency_ = std::chrono::milliseconds(2);
+  slow_disk.write_latency_ = std::chrono::milliseconds(1);
+  DiskManagerMemory slow_dm(slow_disk);
+  auto start = std::chrono::steady_clock::now();
+  slow_dm.WritePage(0, data);
+  slow_dm.ReadPage(0, data);
+  slow_dm.ReadPage(0, data);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5));
+  EXPECT_EQ(std::chrono::milliseconds(5), slow_dm.GetSimulatedTime());
+
+  // Scenario: transfers queue for the bandwidth; 16 pages at 4 MB/s take 16 ms, however they are batched.
+  SimulatedDisk narrow_disk;
+  narrow_disk.bandwidth_ = 4 * 1024 * 1024;
+  DiskManagerMemory narrow_dm(narrow_disk);
+  start = std::chrono::steady_clock::now();
+  std::vector<std::pair<page_id_t, const char *>> batch;
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    narrow_dm.WritePage(page_id, data);
+    batch.emplace_back(page_id + 8, data);
+  }
+  narrow_dm.WritePages(&batch);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(15));
+}
+
+}  // namespace bustub
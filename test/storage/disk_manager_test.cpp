@@ -0,0 +1,473 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_test.cpp
+//
+// Identification: test/storage/disk_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, ReadWritePageTest) {
+  char buf[PAGE_SIZE] = {0};
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  DiskManager dm(db_file);
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  dm.ReadPage(0, buf);  // tolerate empty read
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  std::memset(buf, 0, sizeof(buf));
+  dm.WritePage(5, data);
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  EXPECT_EQ(2, dm.GetNumWrites());
+
+  dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, WritePagesTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  DiskManager dm(db_file);
+
+  // Scenario: an unsorted batch with a run of consecutive pages and a gap.
+  std::vector<page_id_t> page_ids = {4, 1, 2, 9, 3, 0};
+  std::vector<std::vector<char>> data(page_ids.size(), std::vector<char>(PAGE_SIZE));
+  std::vector<std::pair<page_id_t, const char *>> batch;
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    snprintf(data[i].data(), PAGE_SIZE, "page %d", page_ids[i]);
+    batch.emplace_back(page_ids[i], data[i].data());
+  }
+  dm.WritePages(&batch);
+  EXPECT_EQ(6, dm.GetNumWrites());
+  for (size_t i = 1; i < batch.size(); i++) {
+    EXPECT_LT(batch[i - 1].first, batch[i].first);
+  }
+
+  // Scenario: every page landed at its own offset.
+  char buf[PAGE_SIZE] = {0};
+  for (page_id_t page_id : page_ids) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+  }
+
+  // Scenario: an empty batch writes nothing.
+  batch.clear();
+  dm.WritePages(&batch);
+  EXPECT_EQ(6, dm.GetNumWrites());
+
+  dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, WritePagesFailedRunTest) {
+  // The second file of the tablespace cannot be opened, so every write to its stripes fails.
+  std::vector<std::string> db_files{"test.db", "test_stripe1.db"};
+  RemoveDbFiles(db_files[0]);
+  ASSERT_EQ(0, mkdir(db_files[1].c_str(), 0755));
+  DiskManager dm(db_files);
+
+  // Scenario: a batch of three runs, one per stripe, where the run in the middle fails.
+  std::vector<page_id_t> page_ids = {0, 1, STRIPE_SIZE, STRIPE_SIZE + 1, 2 * STRIPE_SIZE, 2 * STRIPE_SIZE + 1};
+  std::vector<std::vector<char>> data(page_ids.size(), std::vector<char>(PAGE_SIZE));
+  std::vector<std::pair<page_id_t, const char *>> batch;
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    snprintf(data[i].data(), PAGE_SIZE, "page %d", page_ids[i]);
+    batch.emplace_back(page_ids[i], data[i].data());
+  }
+  EXPECT_EQ((std::vector<page_id_t>{STRIPE_SIZE, STRIPE_SIZE + 1}), dm.WritePages(&batch));
+
+  // Scenario: the runs before and after the failed one were still written.
+  char buf[PAGE_SIZE] = {0};
+  for (page_id_t page_id : {0, 1, 2 * STRIPE_SIZE, 2 * STRIPE_SIZE + 1}) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+  }
+
+  dm.ShutDown();
+  RemoveDbFiles(db_files[0]);
+  rmdir(db_files[1].c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, ConcurrentReadWriteTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  DiskManager dm(db_file);
+  const int num_threads = 8;
+  const int pages_per_thread = 64;
+
+  // Scenario: threads write and read back their own pages at the same time, and nobody's offset gets mixed up.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&dm, t] {
+      char data[PAGE_SIZE] = {0};
+      char buf[PAGE_SIZE] = {0};
+      for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < pages_per_thread; i++) {
+          page_id_t page_id = i * num_threads + t;
+          snprintf(data, PAGE_SIZE, "page %d round %d", page_id, round);
+          dm.WritePage(page_id, data);
+          dm.ReadPage(page_id, buf);
+          ASSERT_EQ(0, std::memcmp(buf, data, PAGE_SIZE));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread * 4, dm.GetNumWrites());
+
+  // Scenario: a page past the end of the file reads as zeros.
+  char buf[PAGE_SIZE];
+  std::memset(buf, 1, PAGE_SIZE);
+  dm.ReadPage(num_threads * pages_per_thread + 10, buf);
+  char zeros[PAGE_SIZE] = {0};
+  EXPECT_EQ(0, std::memcmp(buf, zeros, PAGE_SIZE));
+
+  dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, DirectIOTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  // One byte past an aligned address is never aligned for O_DIRECT.
+  std::vector<char> unaligned_memory(3 * PAGE_SIZE + DIRECT_IO_ALIGNMENT + 1);
+  auto address = reinterpret_cast<uintptr_t>(unaligned_memory.data());
+  char *unaligned = unaligned_memory.data() + (DIRECT_IO_ALIGNMENT - address % DIRECT_IO_ALIGNMENT) + 1;
+  {
+    DiskManager dm(db_file, true);
+    if (!dm.IsDirectIO()) {
+      // Some file systems, e.g. tmpfs, do not support O_DIRECT; the disk manager then uses the page cache.
+      dm.ShutDown();
+      RemoveDbFiles(db_file);
+      GTEST_SKIP();
+    }
+    auto *aligned = static_cast<char *>(::operator new[](PAGE_SIZE, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+
+    // Scenario: single pages from aligned and unaligned buffers.
+    snprintf(aligned, PAGE_SIZE, "aligned");
+    snprintf(unaligned, PAGE_SIZE, "unaligned");
+    dm.WritePage(0, aligned);
+    dm.WritePage(1, unaligned);
+
+    // Scenario: a batch with a run mixing aligned and unaligned pages.
+    snprintf(unaligned + PAGE_SIZE, PAGE_SIZE, "batch unaligned");
+    std::vector<std::pair<page_id_t, const char *>> batch = {{3, unaligned + PAGE_SIZE}, {2, aligned}};
+    dm.WritePages(&batch);
+
+    // Scenario: an aligned asynchronous write.
+    snprintf(aligned, PAGE_SIZE, "async");
+    dm.WritePageAsync(4, aligned, nullptr);
+    dm.WaitForAsyncIO();
+
+    char buf[PAGE_SIZE];
+    dm.ReadPage(1, buf);
+    EXPECT_EQ("unaligned", std::string(buf));
+    dm.ReadPage(3, unaligned + 2 * PAGE_SIZE);
+    EXPECT_EQ("batch unaligned", std::string(unaligned + 2 * PAGE_SIZE));
+    dm.ShutDown();
+    ::operator delete[](aligned, std::align_val_t{DIRECT_IO_ALIGNMENT});
+  }
+
+  // Scenario: the pages are on disk, where a disk manager without direct I/O finds them.
+  DiskManager dm(db_file);
+  EXPECT_FALSE(dm.IsDirectIO());
+  char buf[PAGE_SIZE];
+  const char *expected[] = {"aligned", "unaligned", "aligned", "batch unaligned", "async"};
+  for (page_id_t page_id = 0; page_id < 5; page_id++) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(expected[page_id], std::string(buf));
+  }
+  dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, PageReuseTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  char data[PAGE_SIZE] = {0};
+  {
+    DiskManager dm(db_file);
+    for (page_id_t page_id = 0; page_id < 10; page_id++) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+      dm.WritePage(page_id, data);
+    }
+
+    // Scenario: deallocated pages are reused, lowest first, before the file grows.
+    dm.DeallocatePage(7);
+    dm.DeallocatePage(3);
+    dm.DeallocatePage(3);
+    // Pages that were never allocated cannot be deallocated.
+    dm.DeallocatePage(42);
+    EXPECT_EQ(2, dm.GetNumFreePages());
+    EXPECT_EQ(3, dm.AllocatePage());
+    EXPECT_EQ(7, dm.AllocatePage());
+    EXPECT_EQ(10, dm.AllocatePage());
+    dm.DeallocatePage(5);
+    dm.ShutDown();
+  }
+
+  // Scenario: after a restart, the free page is still free, and new pages come after the ones in the file.
+  DiskManager dm(db_file);
+  EXPECT_EQ(1, dm.GetNumFreePages());
+  EXPECT_EQ(5, dm.AllocatePage());
+  EXPECT_EQ(10, dm.AllocatePage());
+  dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, UnflushedReuseTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  // A directory in place of the free space map, so that the map can never be flushed.
+  ASSERT_EQ(0, mkdir("test.fsm", 0755));
+  char data[PAGE_SIZE] = {0};
+  char buf[PAGE_SIZE] = {0};
+  DiskManager dm(db_file);
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    EXPECT_EQ(page_id, dm.AllocatePage());
+    snprintf(data, PAGE_SIZE, "page %d", page_id);
+    dm.WritePage(page_id, data);
+  }
+
+  // Scenario: a page reused from the map is not written while the map cannot say on disk that it is in use.
+  dm.DeallocatePage(2);
+  EXPECT_EQ(2, dm.AllocatePage());
+  snprintf(data, PAGE_SIZE, "reused");
+  dm.WritePage(2, data);
+  dm.ReadPage(2, buf);
+  EXPECT_EQ("page 2", std::string(buf));
+  std::vector<std::pair<page_id_t, const char *>> batch = {{2, data}, {1, data}};
+  EXPECT_EQ(std::vector<page_id_t>{2}, dm.WritePages(&batch));
+  bool written = true;
+  dm.WritePageAsync(2, data, [&](bool success) { written = success; });
+  dm.WaitForAsyncIO();
+  EXPECT_FALSE(written);
+
+  // Scenario: pages that did not come from the map are written as usual.
+  dm.ReadPage(1, buf);
+  EXPECT_EQ("reused", std::string(buf));
+  EXPECT_EQ(4, dm.AllocatePage());
+  dm.WritePage(4, data);
+  dm.ReadPage(4, buf);
+  EXPECT_EQ("reused", std::string(buf));
+
+  dm.ShutDown();
+  RemoveDbFiles(db_file);
+  rmdir("test.fsm");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, MappedReadsTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  DiskManager dm(db_file);
+  char data[PAGE_SIZE] = {0};
+  char buf[PAGE_SIZE] = {0};
+  snprintf(data, PAGE_SIZE, "before mapping");
+  dm.WritePage(0, data);
+  ASSERT_TRUE(dm.EnableMappedReads());
+  EXPECT_TRUE(dm.IsMappedReads());
+
+  // Scenario: pages written before and after the mapping was made, also ones that grow the file, read back.
+  dm.ReadPage(0, buf);
+  EXPECT_EQ("before mapping", std::string(buf));
+  for (page_id_t page_id = 0; page_id < 100; page_id += 7) {
+    snprintf(data, PAGE_SIZE, "page %d", page_id);
+    dm.WritePage(page_id, data);
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(std::string(data), std::string(buf));
+  }
+
+  // Scenario: an overwrite is seen by the next read, and a page past the end of the file reads as zeros.
+  snprintf(data, PAGE_SIZE, "overwritten");
+  dm.WritePage(7, data);
+  dm.ReadPage(7, buf);
+  EXPECT_EQ("overwritten", std::string(buf));
+  dm.ReadPage(1000, buf);
+  EXPECT_EQ(0, buf[0]);
+  dm.ShutDown();
+  EXPECT_FALSE(dm.IsMappedReads());
+  RemoveDbFiles(db_file);
+
+  // Scenario: direct I/O bypasses the page cache the mapping reads from, so the two do not mix.
+  DiskManager direct_dm(db_file, true);
+  if (direct_dm.IsDirectIO()) {
+    EXPECT_FALSE(direct_dm.EnableMappedReads());
+  }
+  direct_dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, PageSizeTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+  const size_t large_page_size = 16 * 1024;
+  std::vector<char> data(large_page_size);
+  std::vector<char> buf(large_page_size);
+
+  // Scenario: a file of large pages reads and writes whole pages, synchronously and asynchronously.
+  DiskManager dm(db_file, false, large_page_size);
+  EXPECT_EQ(large_page_size, dm.GetPageSize());
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    EXPECT_EQ(page_id, dm.AllocatePage());
+    std::fill(data.begin(), data.end(), static_cast<char>('a' + page_id));
+    dm.WritePage(page_id, data.data());
+  }
+  dm.ReadPage(2, buf.data());
+  EXPECT_EQ('c', buf.front());
+  EXPECT_EQ('c', buf.back());
+  dm.ReadPageAsync(3, buf.data(), [](bool success) { EXPECT_TRUE(success); });
+  dm.WaitForAsyncIO();
+  EXPECT_EQ('d', buf.back());
+  dm.ShutDown();
+
+  // Scenario: reopened with the same page size, the file still has its four pages.
+  DiskManager reopened(db_file, false, large_page_size);
+  EXPECT_EQ(4, reopened.AllocatePage());
+  reopened.ShutDown();
+  RemoveDbFiles(db_file);
+
+  // Scenario: a file of the smallest pages maps and reads them whole, however large the system's pages are.
+  const size_t small_page_size = MIN_PAGE_SIZE;
+  DiskManager small_dm(db_file, false, small_page_size);
+  for (page_id_t page_id = 0; page_id < 5; page_id++) {
+    std::fill(data.begin(), data.begin() + small_page_size, static_cast<char>('a' + page_id));
+    small_dm.WritePage(page_id, data.data());
+  }
+  ASSERT_TRUE(small_dm.EnableMappedReads());
+  for (page_id_t page_id = 0; page_id < 5; page_id++) {
+    small_dm.ReadPage(page_id, buf.data());
+    EXPECT_EQ(static_cast<char>('a' + page_id), buf[0]);
+    EXPECT_EQ(static_cast<char>('a' + page_id), buf[small_page_size - 1]);
+  }
+  small_dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, StripedTablespaceTest) {
+  std::vector<std::string> db_files{"test.db", "test_stripe1.db", "test_stripe2.db"};
+  for (const auto &db_file : db_files) {
+    RemoveDbFiles(db_file);
+  }
+  const page_id_t num_pages = 2 * STRIPE_SIZE * 3;
+  char data[PAGE_SIZE] = {0};
+  char buf[PAGE_SIZE] = {0};
+
+  // Scenario: pages written one at a time and in a batch are spread evenly over the files and read back.
+  DiskManager dm(db_files);
+  EXPECT_EQ(3, dm.GetNumFiles());
+  EXPECT_FALSE(dm.EnableMappedReads());
+  for (page_id_t page_id = 0; page_id < num_pages / 2; page_id++) {
+    EXPECT_EQ(page_id, dm.AllocatePage());
+    snprintf(data, PAGE_SIZE, "page %d", page_id);
+    dm.WritePage(page_id, data);
+  }
+  std::vector<std::vector<char>> batch_data;
+  std::vector<std::pair<page_id_t, const char *>> batch;
+  for (page_id_t page_id = num_pages / 2; page_id < num_pages; page_id++) {
+    EXPECT_EQ(page_id, dm.AllocatePage());
+    batch_data.emplace_back(PAGE_SIZE, 0);
+    snprintf(batch_data.back().data(), PAGE_SIZE, "page %d", page_id);
+  }
+  for (page_id_t page_id = num_pages / 2; page_id < num_pages; page_id++) {
+    batch.emplace_back(page_id, batch_data[page_id - num_pages / 2].data());
+  }
+  dm.WritePages(&batch);
+  for (const auto &db_file : db_files) {
+    struct stat stat_buf;
+    ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+    EXPECT_EQ(2 * STRIPE_SIZE * PAGE_SIZE, stat_buf.st_size);
+  }
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    snprintf(data, PAGE_SIZE, "page %d", page_id);
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(std::string(data), std::string(buf));
+  }
+  dm.ReadPageAsync(num_pages - 1, buf, [](bool success) { EXPECT_TRUE(success); });
+  dm.WaitForAsyncIO();
+  snprintf(data, PAGE_SIZE, "page %d", num_pages - 1);
+  EXPECT_EQ(std::string(data), std::string(buf));
+
+  // Scenario: an extent starts on a stripe boundary, and the pages skipped to get there can be reused.
+  EXPECT_EQ(num_pages, dm.AllocatePage());
+  EXPECT_EQ(num_pages + STRIPE_SIZE, dm.AllocateExtent(STRIPE_SIZE));
+  EXPECT_EQ(STRIPE_SIZE - 1, dm.GetNumFreePages());
+
+  // Scenario: an invalid page id fails, rather than landing in some page of some file.
+  dm.ReadPageAsync(INVALID_PAGE_ID, buf, [](bool success) { EXPECT_FALSE(success); });
+  dm.WritePageAsync(INVALID_PAGE_ID, data, [](bool success) { EXPECT_FALSE(success); });
+  dm.WaitForAsyncIO();
+  dm.ShutDown();
+
+  // Scenario: reopened with the same files, the tablespace ends after the last page of any file.
+  DiskManager reopened(db_files);
+  reopened.ReadPage(STRIPE_SIZE + 1, buf);
+  snprintf(data, PAGE_SIZE, "page %d", STRIPE_SIZE + 1);
+  EXPECT_EQ(std::string(data), std::string(buf));
+  EXPECT_EQ(num_pages, reopened.AllocateExtent(1));
+  reopened.ShutDown();
+  for (const auto &db_file : db_files) {
+    RemoveDbFiles(db_file);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, LargeFileTest) {
+  std::string db_file("test.db");
+  RemoveDbFiles(db_file);
+
+  // Scenario: a file over 2 GiB, sparse so that the test writes nothing, still numbers new pages after its last one.
+  int64_t file_size = int64_t{3} << 30;
+  {
+    FILE *file = fopen(db_file.c_str(), "w");
+    ASSERT_NE(nullptr, file);
+    ASSERT_EQ(0, ftruncate(fileno(file), file_size));
+    fclose(file);
+  }
+  DiskManager dm(db_file);
+  EXPECT_EQ(file_size / PAGE_SIZE, dm.AllocatePage());
+  dm.ShutDown();
+  RemoveDbFiles(db_file);
+}
+
+}  // namespace bustub
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_test.cpp
+//
+// Identification: test/storage/free_space_map_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "storage/disk/free_space_map.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, SampleTest) {
+  std::string file_name("test.fsm");
+  remove(file_name.c_str());
+  const auto num_pages = static_cast<page_id_t>(3 * FreeSpaceMap::PAGES_PER_MAP_PAGE);
+  {
+    FreeSpaceMap map(file_name, num_pages);
+
+    // Scenario: nothing is free in a new map, and it does not create its file for that.
+    EXPECT_EQ(INVALID_PAGE_ID, map.Take());
+    EXPECT_EQ(nullptr, fopen(file_name.c_str(), "r"));
+
+    // Scenario: the lowest free page comes first, whatever order pages were freed in, across map pages.
+    map.Free(num_pages - 1);
+    map.Free(70);
+    map.Free(5);
+    map.Free(5);
+    EXPECT_EQ(3, map.GetNumFree());
+    EXPECT_EQ(5, map.Take());
+    EXPECT_EQ(70, map.Take());
+    EXPECT_FALSE(map.IsFree(70));
+    map.Free(2);
+    EXPECT_EQ(2, map.Take());
+    EXPECT_TRUE(map.IsFree(num_pages - 1));
+
+    // Scenario: changes reach the file when the map is flushed, not before, and the pages taken are safe to use then.
+    EXPECT_EQ(nullptr, fopen(file_name.c_str(), "r"));
+    EXPECT_TRUE(map.IsTakenUnflushed(70));
+    EXPECT_TRUE(map.Flush());
+    EXPECT_FALSE(map.IsTakenUnflushed(70));
+    FILE *file = fopen(file_name.c_str(), "r");
+    ASSERT_NE(nullptr, file);
+    fclose(file);
+    map.Free(100);
+  }
+
+  // Scenario: the map is back after a reopen, with the changes since the last flush written when it was closed.
+  {
+    FreeSpaceMap map(file_name, num_pages);
+    EXPECT_EQ(2, map.GetNumFree());
+    EXPECT_EQ(100, map.Take());
+  }
+
+  // Scenario: pages past the end of a shorter database file are not free.
+  {
+    FreeSpaceMap map(file_name, 1000);
+    EXPECT_EQ(0, map.GetNumFree());
+    EXPECT_EQ(INVALID_PAGE_ID, map.Take());
+  }
+  FreeSpaceMap map(file_name, num_pages);
+  EXPECT_EQ(0, map.GetNumFree());
+  map.Close();
+
+  remove(file_name.c_str());
+}
+
+}  // namespace bustub
@@ -0,0 +1,192 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard_test.cpp
+//
+// Identification: test/storage/page_guard_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/db_files.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, SampleTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  Page *page0 = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page0);
+
+  // Scenario: a guard adds a pin while it lives and drops it when it goes out of scope.
+  {
+    BasicPageGuard guard = bpm->FetchPageBasic(page_id);
+    ASSERT_TRUE(guard);
+    EXPECT_EQ(page_id, guard.PageId());
+    EXPECT_EQ(page0->GetData(), guard.GetData());
+    EXPECT_EQ(2, page0->GetPinCount());
+  }
+  EXPECT_EQ(1, page0->GetPinCount());
+
+  // Scenario: moving a guard moves the pin instead of copying it, and Drop is idempotent.
+  {
+    BasicPageGuard guard = bpm->FetchPageBasic(page_id);
+    BasicPageGuard moved(std::move(guard));
+    EXPECT_FALSE(guard);  // NOLINT
+    EXPECT_EQ(2, page0->GetPinCount());
+    BasicPageGuard assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(2, page0->GetPinCount());
+    assigned.Drop();
+    assigned.Drop();
+    EXPECT_EQ(1, page0->GetPinCount());
+  }
+  EXPECT_EQ(1, page0->GetPinCount());
+
+  // Scenario: a write guard carries the dirty flag to the unpin.
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  EXPECT_FALSE(page0->IsDirty());
+  {
+    WritePageGuard guard = bpm->FetchPageWrite(page_id);
+    ASSERT_TRUE(guard);
+    snprintf(guard.GetDataMut(), PAGE_SIZE, "Hello");
+  }
+  EXPECT_TRUE(page0->IsDirty());
+  EXPECT_EQ(0, page0->GetPinCount());
+
+  // Scenario: the latches are released with the guards, so taking them in turn never blocks.
+  {
+    ReadPageGuard first = bpm->FetchPageRead(page_id);
+    ReadPageGuard second = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(0, strcmp(first.GetData(), "Hello"));
+    EXPECT_EQ(2, page0->GetPinCount());
+    // A read guard only hands out views that cannot be written through.
+    static_assert(std::is_same_v<decltype(first.As<char>()), const char *>);
+  }
+  {
+    WritePageGuard guard = bpm->FetchPageBasic(page_id).UpgradeWrite();
+    ASSERT_TRUE(guard);
+    EXPECT_EQ(1, page0->GetPinCount());
+  }
+  {
+    ReadPageGuard guard = bpm->FetchPageBasic(page_id).UpgradeRead();
+    ASSERT_TRUE(guard);
+  }
+  page0->WLatch();
+  page0->WUnlatch();
+  EXPECT_EQ(0, page0->GetPinCount());
+
+  // Scenario: a guard whose page could not be brought in is empty, and dropping it is harmless.
+  {
+    BasicPageGuard pinned[buffer_pool_size];
+    for (auto &guard : pinned) {
+      page_id_t new_page_id;
+      guard = bpm->NewPageGuarded(&new_page_id);
+      ASSERT_TRUE(guard);
+    }
+    page_id_t new_page_id;
+    EXPECT_FALSE(bpm->NewPageGuarded(&new_page_id));
+    EXPECT_FALSE(bpm->FetchPageRead(page_id));
+  }
+
+  // Scenario: once the guards are gone, every frame can be reused again.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t new_page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&new_page_id));
+  }
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, OptimisticReadTest) {
+  const std::string db_name = "test.db";
+  RemoveDbFiles(db_name);
+  const size_t buffer_pool_size = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+
+  // Scenario: a read with no writer in between validates; one that overlaps a writer does not.
+  uint64_t version = page->BeginOptimisticRead();
+  EXPECT_TRUE(page->ValidateOptimisticRead(version));
+  page->WLatch();
+  EXPECT_FALSE(page->ValidateOptimisticRead(version));
+  EXPECT_FALSE(page->ValidateOptimisticRead(page->BeginOptimisticRead()));
+  page->WUnlatch();
+  EXPECT_FALSE(page->ValidateOptimisticRead(version));
+  EXPECT_TRUE(page->ValidateOptimisticRead(page->BeginOptimisticRead()));
+
+  // Scenario: the read latch does not invalidate optimistic reads.
+  version = page->BeginOptimisticRead();
+  page->RLatch();
+  page->RUnlatch();
+  EXPECT_TRUE(page->ValidateOptimisticRead(version));
+
+  // Scenario: readers never see a half-written page, even though the writer keeps both halves changing.
+  const int num_writes = 20000;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 2; t++) {
+    readers.emplace_back([&] {
+      BasicPageGuard guard = bpm->FetchPageBasic(page_id);
+      while (!done.load()) {
+        int first;
+        int last;
+        guard.ReadOptimistic<char>([&](const char *data) {
+          first = Page::LoadOptimistic<int>(data);
+          last = Page::LoadOptimistic<int>(data + PAGE_SIZE - sizeof(int));
+        });
+        ASSERT_EQ(first, last);
+      }
+    });
+  }
+  for (int i = 1; i <= num_writes; i++) {
+    WritePageGuard guard = bpm->FetchPageWrite(page_id);
+    char *data = guard.GetDataMut();
+    memcpy(data, &i, sizeof(int));
+    memcpy(data + PAGE_SIZE - sizeof(int), &i, sizeof(int));
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -11,20 +11,25 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <cstdlib>
 #include <cstdio>
 #include <iostream>
 #include <string>
+#include <thread>  // NOLINT
+#include <tuple>
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/db_files.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
-TEST(TupleTest, DISABLED_TableHeapTest) {
+TEST(TupleTest, TableHeapTest) {
   // test1: parse create sql statement
   std::string create_stmt = "a varchar(20), b smallint, c bigint, d bool, e varchar(16)";
   Column col1{"a", TypeId::VARCHAR, 20};
@@ -38,8 +43,9 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
 
   // create transaction
   auto *transaction = new Transaction(0);
+  RemoveDbFiles("test.db");
   auto *disk_manager = new DiskManager("test.db");
-  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
   auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
   auto *log_manager = new LogManager(disk_manager);
   auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
@@ -57,6 +63,14 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
     ++itr;
   }
 
+  // a scan through a small private ring sees every tuple as well
+  BufferAccessStrategy strategy(buffer_pool_manager, 4);
+  size_t num_tuples = 0;
+  for (auto ring_itr = table->Begin(transaction, &strategy); ring_itr != table->End(); ++ring_itr) {
+    num_tuples++;
+  }
+  EXPECT_EQ(rid_v.size(), num_tuples);
+
   // int i = 0;
   std::shuffle(rid_v.begin(), rid_v.end(), std::default_random_engine(0));
   for (const auto &rid : rid_v) {
@@ -64,11 +78,277 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
     assert(table->MarkDelete(rid, transaction) == 1);
   }
   disk_manager->ShutDown();
-  remove("test.db");  // remove db file
-  remove("test.log");
+  RemoveDbFiles("test.db");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapExtentTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  auto *transaction = new Transaction(0);
+  RemoveDbFiles("test.db");
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table_a = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+  auto *table_b = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+
+  // Scenario: two tables grow at the same time, yet each keeps its pages contiguous within an extent.
+  RID rid;
+  for (int i = 0; i < 3000; ++i) {
+    ASSERT_TRUE(table_a->InsertTuple(tuple, &rid, transaction));
+    ASSERT_TRUE(table_b->InsertTuple(tuple, &rid, transaction));
+  }
+  for (auto *table : {table_a, table_b}) {
+    std::vector<page_id_t> page_ids;
+    for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+      if (page_ids.empty() || page_ids.back() != itr->GetRid().GetPageId()) {
+        page_ids.push_back(itr->GetRid().GetPageId());
+      }
+    }
+    ASSERT_GT(page_ids.size(), 1);
+    ASSERT_LE(page_ids.size(), static_cast<size_t>(EXTENT_SIZE));
+    for (size_t i = 1; i < page_ids.size(); i++) {
+      EXPECT_EQ(page_ids[i - 1] + 1, page_ids[i]);
+    }
+  }
+  EXPECT_EQ(EXTENT_SIZE, std::abs(table_a->GetFirstPageId() - table_b->GetFirstPageId()));
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+  delete table_b;
+  delete table_a;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapPageSizeTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  // Scenario: the same rows take fewer, larger pages in a file with 32 KB pages than with the default page size.
+  std::vector<size_t> num_pages;
+  for (size_t page_size : {static_cast<size_t>(PAGE_SIZE), static_cast<size_t>(32 * 1024)}) {
+    auto *transaction = new Transaction(0);
+    RemoveDbFiles("test.db");
+    auto *disk_manager = new DiskManager("test.db", false, page_size);
+    auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+    auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+    auto *log_manager = new LogManager(disk_manager);
+    auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+    RID rid;
+    for (int i = 0; i < 3000; ++i) {
+      ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    }
+    size_t num_tuples = 0;
+    std::vector<page_id_t> page_ids;
+    for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+      num_tuples++;
+      if (page_ids.empty() || page_ids.back() != itr->GetRid().GetPageId()) {
+        page_ids.push_back(itr->GetRid().GetPageId());
+      }
+    }
+    EXPECT_EQ(3000, num_tuples);
+    num_pages.push_back(page_ids.size());
+
+    disk_manager->ShutDown();
+    RemoveDbFiles("test.db");
+    delete table;
+    delete log_manager;
+    delete lock_manager;
+    delete buffer_pool_manager;
+    delete disk_manager;
+    delete transaction;
+  }
+  EXPECT_GE(num_pages[0], num_pages[1] * 4);
+}
+
+namespace {
+
+/**
+ * Counts the read-ahead requests a table scan makes. The requests are read as the scan moves on to its next page, as
+ * if each took the disk about as long as the scan takes for a page, and the pages the scan had to wait for are noted.
+ */
+class CountingBufferPoolManager : public BufferPoolManagerInstance {
+ public:
+  using BufferPoolManagerInstance::BufferPoolManagerInstance;
+
+  size_t prefetch_requests_{0};
+  /** Pages looked up by the read-ahead requests, as often as they were. */
+  size_t read_ahead_pages_{0};
+  std::vector<page_id_t> missed_pages_;
+
+ protected:
+  Page *FetchPageWithStrategyImpl(page_id_t page_id, BufferAccessStrategy *strategy) override {
+    uint64_t misses = GetStats().misses_;
+    Page *page = BufferPoolManagerInstance::FetchPageWithStrategyImpl(page_id, strategy);
+    if (page_id == last_page_id_) {
+      return page;
+    }
+    last_page_id_ = page_id;
+    if (GetStats().misses_ > misses) {
+      missed_pages_.push_back(page_id);
+    }
+    for (const auto &[first_page_id, depth, next_page] : pending_) {
+      page_id_t read_page_id = first_page_id;
+      for (size_t i = 0; i < depth && read_page_id != INVALID_PAGE_ID; i++) {
+        read_ahead_pages_++;
+        read_page_id = ReadAhead(read_page_id, i + 1 == depth ? nullptr : next_page);
+      }
+    }
+    pending_.clear();
+    return page;
+  }
+
+  void PrefetchPageImpl(page_id_t page_id, size_t depth, const next_page_fn &next_page) override {
+    if (page_id != INVALID_PAGE_ID) {
+      prefetch_requests_++;
+      pending_.emplace_back(page_id, depth, next_page);
+    }
+  }
+
+ private:
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  std::vector<std::tuple<page_id_t, size_t, next_page_fn>> pending_;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapReadAheadTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+  auto *transaction = new Transaction(0);
+  RemoveDbFiles("test.db");
+  auto *disk_manager = new DiskManager("test.db");
+  auto *loading_buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *loading_table = new TableHeap(loading_buffer_pool_manager, lock_manager, log_manager, transaction);
+  RID rid;
+  for (int i = 0; i < 3000; ++i) {
+    ASSERT_TRUE(loading_table->InsertTuple(tuple, &rid, transaction));
+  }
+  page_id_t first_page_id = loading_table->GetFirstPageId();
+  loading_buffer_pool_manager->FlushAllPages();
+  delete loading_table;
+  delete loading_buffer_pool_manager;
+
+  // The scan starts with none of the table's pages resident.
+  auto *buffer_pool_manager = new CountingBufferPoolManager(50, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, first_page_id);
+
+  // Scenario: a scan queues one read-ahead per half window of READ_AHEAD_PAGES pages, not one per page.
+  std::vector<page_id_t> page_ids;
+  for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+    if (page_ids.empty() || page_ids.back() != itr->GetRid().GetPageId()) {
+      page_ids.push_back(itr->GetRid().GetPageId());
+    }
+  }
+  size_t num_pages = page_ids.size();
+  size_t half_window = READ_AHEAD_PAGES / 2;
+  ASSERT_GT(num_pages, 4 * static_cast<size_t>(READ_AHEAD_PAGES));
+  EXPECT_LE(buffer_pool_manager->prefetch_requests_, num_pages / half_window + 1);
+  EXPECT_GE(buffer_pool_manager->prefetch_requests_, (num_pages - 1) / half_window);
+
+  // Scenario: each window continues from the last page of the one before, so only that page is requested twice.
+  EXPECT_LE(buffer_pool_manager->read_ahead_pages_, num_pages + buffer_pool_manager->prefetch_requests_);
+
+  // Scenario: only the pages before read-ahead got going are waited for; every page after a window boundary was read
+  // while the scan was still a page or more behind.
+  EXPECT_EQ((std::vector<page_id_t>{page_ids[0], page_ids[1]}), buffer_pool_manager->missed_pages_);
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapOptimisticReadTest) {
+  // A wide tuple, so that an update takes long enough for readers to overlap it.
+  const uint32_t num_cols = 128;
+  std::vector<Column> cols;
+  for (uint32_t i = 0; i < num_cols; i++) {
+    cols.emplace_back("c" + std::to_string(i), TypeId::BIGINT);
+  }
+  Schema schema{cols};
+  auto make_tuple = [&](int64_t value) {
+    return Tuple(std::vector<Value>(num_cols, ValueFactory::GetBigIntValue(value)), &schema);
+  };
+  auto *transaction = new Transaction(0);
+  RemoveDbFiles("test.db");
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(10, disk_manager);
+  auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+  RID rid;
+  ASSERT_TRUE(table->InsertTuple(make_tuple(0), &rid, transaction));
+
+  // Scenario: without the page latch, a read returns the tuple and reports slots that hold none.
+  Tuple result;
+  ASSERT_TRUE(table->GetTuple(rid, &result, transaction));
+  EXPECT_EQ(0, result.GetValue(&schema, num_cols - 1).GetAs<int64_t>());
+  EXPECT_FALSE(table->GetTuple(RID(rid.GetPageId(), rid.GetSlotNum() + 1), &result, transaction));
+
+  // Scenario: readers never see a half-updated tuple, even though the writer keeps all of its columns changing.
+  const int num_updates = 5000;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 2; t++) {
+    readers.emplace_back([&, t] {
+      Transaction reader_txn(t + 1);
+      Tuple tuple;
+      while (!done.load()) {
+        ASSERT_TRUE(table->GetTuple(rid, &tuple, &reader_txn));
+        ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int64_t>(), tuple.GetValue(&schema, num_cols - 1).GetAs<int64_t>());
+      }
+    });
+  }
+  for (int i = 1; i <= num_updates; i++) {
+    ASSERT_TRUE(table->UpdateTuple(make_tuple(i), rid, transaction));
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  ASSERT_TRUE(table->GetTuple(rid, &result, transaction));
+  EXPECT_EQ(num_updates, result.GetValue(&schema, 0).GetAs<int64_t>());
+
+  disk_manager->ShutDown();
+  RemoveDbFiles("test.db");
   delete table;
+  delete log_manager;
+  delete lock_manager;
   delete buffer_pool_manager;
   delete disk_manager;
+  delete transaction;
 }
 
 }  // namespace bustub
@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_bench.cpp
+//
+// Identification: tools/replacer_bench/replacer_bench.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Compares the replacement policies on a page access trace.
+//
+//   replacer-bench [--trace=FILE] [--save=FILE] [--workload=zipf|scan|mixed]
+//                  [--pages=N] [--accesses=N] [--frames=N] [--k=N]
+//
+// Without --trace, the trace is recorded by running a synthetic workload against a BufferPoolManagerInstance on an
+// in-memory disk, through the FetchPage callback, and can be kept with --save. The trace is then replayed against
+// every policy with a pool of --frames frames.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/access_trace.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/replacer_benchmark.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+namespace {
+
+struct Options {
+  std::string trace_file_;
+  std::string save_file_;
+  std::string workload_{"mixed"};
+  size_t num_pages_{10000};
+  size_t num_accesses_{200000};
+  size_t num_frames_{1000};
+  size_t k_{LRUK_REPLACER_K};
+};
+
+/** Parses a positive count, rejecting zero, signs, anything that is not a number and numbers too large to be sane. */
+bool ParseCount(const std::string &value, size_t *count) {
+  if (value.empty() || value.size() > 12 || value.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  *count = std::stoul(value);
+  return *count > 0;
+}
+
+bool ParseOptions(int argc, char **argv, Options *options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    size_t eq = arg.find('=');
+    if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+      return false;
+    }
+    std::string key = arg.substr(2, eq - 2);
+    std::string value = arg.substr(eq + 1);
+    if (key == "trace") {
+      options->trace_file_ = value;
+    } else if (key == "save") {
+      options->save_file_ = value;
+    } else if (key == "workload") {
+      options->workload_ = value;
+    } else if (key == "pages") {
+      if (!ParseCount(value, &options->num_pages_)) {
+        return false;
+      }
+    } else if (key == "accesses") {
+      if (!ParseCount(value, &options->num_accesses_)) {
+        return false;
+      }
+    } else if (key == "frames") {
+      if (!ParseCount(value, &options->num_frames_)) {
+        return false;
+      }
+    } else if (key == "k") {
+      if (!ParseCount(value, &options->k_)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return options->workload_ == "zipf" || options->workload_ == "scan" || options->workload_ == "mixed";
+}
+
+/** Draws page numbers from a Zipfian distribution over [0, num_pages), page 0 being the hottest. */
+class ZipfGenerator {
+ public:
+  ZipfGenerator(size_t num_pages, double theta) : cdf_(num_pages) {
+    double sum = 0;
+    for (size_t i = 0; i < num_pages; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+      cdf_[i] = sum;
+    }
+    for (double &value : cdf_) {
+      value /= sum;
+    }
+  }
+
+  size_t Next(std::mt19937_64 *rng) {
+    double u = std::uniform_real_distribution<double>(0, 1)(*rng);
+    return std::min(cdf_.size() - 1, static_cast<size_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin()));
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+/** Runs a synthetic workload against a real buffer pool, recording every fetch into the trace. */
+void RecordWorkload(const Options &options, AccessTrace *trace) {
+  auto disk_manager = std::make_unique<DiskManagerMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(options.num_frames_, disk_manager.get());
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < options.num_pages_; i++) {
+    page_id_t page_id;
+    if (bpm->NewPage(&page_id) == nullptr) {
+      break;
+    }
+    // Dirty, so that the page is on disk once it is evicted and can be read back.
+    bpm->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+
+  std::mt19937_64 rng(15445);
+  ZipfGenerator zipf(page_ids.size(), 0.99);
+  size_t scan_position = 0;
+  AccessTrace::StartRecording(trace);
+  for (size_t i = 0; i < options.num_accesses_; i++) {
+    // The mixed workload is a skewed point lookup load interrupted by a long sequential scan every so often, the
+    // pattern that tells scan-resistant policies apart from the others.
+    bool scanning = options.workload_ == "scan" || (options.workload_ == "mixed" && (i / 5000) % 4 == 3);
+    page_id_t page_id = scanning ? page_ids[scan_position++ % page_ids.size()] : page_ids[zipf.Next(&rng)];
+    if (bpm->FetchPage(page_id, AccessTrace::RecordCallback) != nullptr) {
+      bpm->UnpinPage(page_id, false);
+    }
+  }
+  AccessTrace::StopRecording();
+
+  bpm.reset();
+  disk_manager->ShutDown();
+}
+
+int Run(int argc, char **argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: " << argv[0] << " [--trace=FILE] [--save=FILE] [--workload=zipf|scan|mixed]"
+              << " [--pages=N] [--accesses=N] [--frames=N] [--k=N]" << std::endl;
+    return 1;
+  }
+
+  AccessTrace trace;
+  if (!options.trace_file_.empty()) {
+    if (!AccessTrace::Load(options.trace_file_, &trace)) {
+      std::cerr << "could not read trace " << options.trace_file_ << std::endl;
+      return 1;
+    }
+  } else {
+    RecordWorkload(options, &trace);
+    if (!options.save_file_.empty() && !trace.Save(options.save_file_)) {
+      std::cerr << "could not write trace " << options.save_file_ << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << trace.GetAccesses().size() << " accesses, " << options.num_frames_ << " frames" << std::endl;
+  for (ReplacerType replacer_type : {ReplacerType::CLOCK, ReplacerType::LRU_K, ReplacerType::TWO_QUEUE}) {
+    std::unique_ptr<Replacer> replacer(Replacer::Create(replacer_type, options.num_frames_, options.k_));
+    ReplayResult result = ReplacerBenchmark::Replay(trace, replacer.get(), options.num_frames_);
+    std::cout << result.ToString(ReplacerBenchmark::PolicyName(replacer_type)) << std::endl;
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace bustub
+
+int main(int argc, char **argv) { return bustub::Run(argc, argv); }